@@ -43,42 +43,541 @@
 
 // Operator priority: NOT > AND > XOR > OR
 
+// Options:
+// --stats               Output per phase statistics to stderr
+// --perf                Add hardware counters (Linux perf_event) to the statistics
+// --trace FILE          Write phase and worker spans as Chrome trace-event JSON, tid is the worker index
+// --alloc-free P[,P..]  Exit 1 if a phase named P (name prefix) performs any heap allocation.
+//                       Only covers those phases, not the whole run. Needs -DQMA_ALLOC_TRACK
+// --no-table            Don't output the true value table
+// --threads N           Worker threads for the parallel phases (default 1)
+// --pla FILE            Read a Berkeley PLA file (type f, fd, fr or fdr) instead of an expression
+//                       Directives besides .i .o .ilb .ob .type .p .e are rejected
+// --out-pla FILE        Write the minimized cover as a PLA file
+// --blif FILE           Write the minimized cover as a BLIF model
+// --cover METHOD        gpl or chvatal greedy heuristics, exact branch-and-bound,
+//                       sat (minimum number of terms by the built-in SAT solver), lagr (Lagrangian heuristic),
+//                       auto (default, exact on small independent parts of the problem, lagr on large ones).
+//                       exact stops after 10^6 nodes and sat after 200000 conflicts; the cover is then
+//                       reported as not proven optimal and --bound falls back to the Lagrangian bound
+// --bound               Report a lower bound on the number of terms and the gap of the cover.
+//                       For expand it is a greedy set of ON minterms no implicant covers two of
+// --improve MS          Improve the cover by local search for up to MS milliseconds. qm engine only,
+//                       skipped when exact proved every part of the cover minimum
+// --engine ENGINE       auto (default, picked per function, the choice and reason are in --stats),
+//                       qm (all primes then cover), expand (expand uncovered minterms into primes one
+//                       at a time, heuristic, for functions with too many primes), npn (table of 4-variable classes),
+//                       word (up to 6 variables in one word), unate or affine (direct minimum covers).
+//                       Engines that don't apply to a function fall back to qm.
+//                       The word phase (primes and cover of word) performs no heap allocation;
+//                       parsing, the table, engine selection and output around it still allocate
+// --primes METHOD       Prime generation of the qm engine: merge (pairwise merging rounds), consensus
+//                       (iterated consensus, for sparse functions), symmetry (by cube types over groups of
+//                       symmetric variables) or auto (default, symmetry if there are symmetric variables,
+//                       else consensus if few implicants are estimated). Symmetry only speeds up prime
+//                       generation, the types are expanded into all their primes and covering doesn't use
+//                       the symmetry
+
+// Benchmark: qma bench [--repeat N] [--threshold PCT] [--save FILE] [--compare FILE]
+// Runs the built-in cases N times and reports median and MAD of the wall time per iteration,
+// each run repeats its case for at least 50 ms
+// With --compare, exits 1 if any case is significantly slower than the baseline
+// qma bench --scaling [--max-threads N] runs dense and sparse cases at 1, 2, 4, ... threads
+
+// Generator: qma gen expr [--vars N] [--depth D] [--ops OPS] [--seed S] [--count C]
+//            qma gen set [--vars N] [--density P] [--dc Q] [--seed S] [--count C]
+// Sets are written as a PLA (type fd) with one output per set
+// OPS is a weighted operator mix, e.g. "++*^'" makes OR twice as likely
+// qma gen npn prints the embedded NPN class database
+// Output is reproducible for the same seed on every platform
+
 // STL includes
 #include <set>
+#include <deque>
+#include <queue>
 #include <stack>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <iostream>
+#include <sstream>
 #include <algorithm>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
 #include <functional>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
 #include <unordered_map>
 #include <unordered_set>
 
 // Input
-std::string input;
+std::string input, ipla, opla, oblif, ocover = "auto", oengine = "auto", oprimes = "auto";
+bool otable = true;
+int othreads = 1;
+double oimprove = 0;
+
+// Lower bound report, summed over outputs
+bool obound = false;
+size_t bterms = 0;
+double blb = 0;
 
 // Analyze
 std::set<char> var;
 std::unordered_map<char, int> mvar;
 std::vector<size_t> m;
+std::vector<uint64_t> on;
+bool mono = false;
+int nxor = -1;
 bool validate();
+bool parse();
 void analyze();
+void reset();
+bool pla();
+std::string sop(const std::vector<std::string>& sl, const std::vector<std::string>& nms);
+void writePla(const std::string& file, const std::vector<std::string>& ilb, const std::vector<std::string>& ob,
+              const std::vector<std::vector<std::string>>& cvs);
+void writeBlif(const std::string& file, const std::vector<std::string>& ilb, const std::vector<std::string>& ob,
+               const std::vector<std::vector<std::string>>& cvs);
+int bench(int argc, char *argv[]);
+int gen(int argc, char *argv[]);
+void pfor(size_t n, const std::function<void(size_t)>& f);
+
+// Worker index of the thread, the main thread is 0; also the trace tid
+thread_local int wid = 0;
+
+// Statistics
+// Each phase owns a fixed slot, so that opening a phase never allocates
+struct PhaseStat {
+    char name[24];
+    bool nalloc;
+    std::atomic<size_t> allocs, bytes;
+    double ms;
+    uint64_t pc[4];
+};
+const int MAXPH = 64;
+PhaseStat phs[MAXPH];
+int nph = 0;
+std::atomic<int> cph(-1);
+bool ostats = false;
+std::vector<std::string> afree;
+std::vector<std::string> notes;
+void report();
+bool check();
+void clearStats();
+
+// Hardware counters
+// Cycles, instructions, cache misses, branch misses
+int pfd[4] = {-1, -1, -1, -1};
+bool operf = false;
+void perfOpen();
+void perfRead(uint64_t *v);
+
+// Phase guard
+class Phase {
+    private:
+        int id, prv;
+        std::chrono::steady_clock::time_point st;
+        uint64_t ps[4];
+        int64_t ts;
+
+    public:
+        Phase(const char* name, int idx = -1, bool nalloc = false);
+        Phase(const Phase&) = delete;
+        ~Phase();
+        Phase& operator=(const Phase&) = delete;
+};
+
+// Trace events
+// Names must be string literals, the index is appended on output
+struct TraceEvent {
+    const char *name;
+    int idx, tid;
+    int64_t ts, dur;
+};
+std::string otrace;
+std::vector<TraceEvent> tev;
+std::mutex tmtx;
+std::chrono::steady_clock::time_point tst = std::chrono::steady_clock::now();
+int64_t tnow();
+void trace(const char *name, int idx, int64_t ts);
+void traceOut();
+
+// Trace span guard
+class Span {
+    private:
+        const char *name;
+        int idx;
+        int64_t ts;
+
+    public:
+        Span(const char *name, int idx = -1): name(name), idx(idx), ts(otrace.size() ? tnow() : 0) {}
+        Span(const Span&) = delete;
+        ~Span() {
+            if (otrace.size())
+                trace(name, idx, ts);
+        }
+        Span& operator=(const Span&) = delete;
+};
+
+#ifdef QMA_ALLOC_TRACK
+// Allocation tracking
+// Attribute every allocation to the current phase. Every replaced new has its matching delete;
+// free() sits behind a non-inlined call, else GCC pairs it with the inlined new and warns
+void* talloc(size_t sz, size_t al) {
+    int p = cph.load(std::memory_order_relaxed);
+    if (p >= 0) {
+        phs[p].allocs.fetch_add(1, std::memory_order_relaxed);
+        phs[p].bytes.fetch_add(sz, std::memory_order_relaxed);
+    }
+    void *rtn = nullptr;
+    if (al <= alignof(std::max_align_t))
+        rtn = std::malloc(sz ? sz : 1);
+    else if (posix_memalign(&rtn, al, sz ? sz : 1))
+        rtn = nullptr;
+    if (!rtn)
+        throw std::bad_alloc();
+    return rtn;
+}
+__attribute__((noinline)) void tfree(void *p) noexcept {
+    std::free(p);
+}
+void* operator new(size_t sz) {
+    return talloc(sz, 0);
+}
+void* operator new[](size_t sz) {
+    return talloc(sz, 0);
+}
+void* operator new(size_t sz, std::align_val_t al) {
+    return talloc(sz, (size_t)al);
+}
+void* operator new[](size_t sz, std::align_val_t al) {
+    return talloc(sz, (size_t)al);
+}
+void operator delete(void *p) noexcept {
+    tfree(p);
+}
+void operator delete[](void *p) noexcept {
+    tfree(p);
+}
+void operator delete(void *p, size_t) noexcept {
+    tfree(p);
+}
+void operator delete[](void *p, size_t) noexcept {
+    tfree(p);
+}
+void operator delete(void *p, std::align_val_t) noexcept {
+    tfree(p);
+}
+void operator delete[](void *p, std::align_val_t) noexcept {
+    tfree(p);
+}
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+    tfree(p);
+}
+void operator delete[](void *p, size_t, std::align_val_t) noexcept {
+    tfree(p);
+}
+#endif
 
 // Main
-int main() {
-    // Input expression
+int main(int argc, char *argv[]) {
     std::ios::sync_with_stdio(false);
-    std::cout << "Input expression: ";
-    std::cin >> input;
+    // Subcommands
+    if (argc > 1 && !std::strcmp(argv[1], "bench"))
+        return bench(argc - 1, argv + 1);
+    if (argc > 1 && !std::strcmp(argv[1], "gen"))
+        return gen(argc - 1, argv + 1);
 
-    // Validating
-    if (!validate())
-        return 0;
+    // Parse options
+    for (int i = 1; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt == "--stats")
+            ostats = true;
+        else if (opt == "--trace" && i + 1 < argc)
+            otrace = argv[++i];
+        else if (opt == "--perf")
+            ostats = operf = true;
+        else if (opt == "--no-table")
+            otable = false;
+        else if (opt == "--pla" && i + 1 < argc)
+            ipla = argv[++i];
+        else if (opt == "--out-pla" && i + 1 < argc)
+            opla = argv[++i];
+        else if (opt == "--blif" && i + 1 < argc)
+            oblif = argv[++i];
+        else if (opt == "--bound")
+            ostats = obound = true;
+        else if (opt == "--improve" && i + 1 < argc)
+            oimprove = std::atof(argv[++i]);
+        else if (opt == "--cover" && i + 1 < argc) {
+            ocover = argv[++i];
+            if (ocover == "lagr")
+                ostats = obound = true;
+            if (ocover != "gpl" && ocover != "chvatal" && ocover != "exact" && ocover != "sat" && ocover != "lagr" && ocover != "auto") {
+                std::cerr << "[ERROR] Unknown cover '" << ocover << '\'' << std::endl;
+                return 1;
+            }
+        }
+        else if (opt == "--engine" && i + 1 < argc) {
+            oengine = argv[++i];
+            if (oengine != "auto" && oengine != "qm" && oengine != "expand" && oengine != "npn" && oengine != "word" &&
+                oengine != "unate" && oengine != "affine") {
+                std::cerr << "[ERROR] Unknown engine '" << oengine << '\'' << std::endl;
+                return 1;
+            }
+        }
+        else if (opt == "--primes" && i + 1 < argc) {
+            oprimes = argv[++i];
+            if (oprimes != "merge" && oprimes != "consensus" && oprimes != "symmetry" && oprimes != "auto") {
+                std::cerr << "[ERROR] Unknown prime generation '" << oprimes << '\'' << std::endl;
+                return 1;
+            }
+        }
+        else if (opt == "--threads" && i + 1 < argc)
+            othreads = std::max(1, std::atoi(argv[++i]));
+        else if (opt == "--alloc-free" && i + 1 < argc) {
+            std::string tmp;
+            for (const char *j = argv[++i]; ; ++j)
+                if (*j == ',' || !*j) {
+                    if (tmp.size())
+                        afree.emplace_back(tmp);
+                    tmp.clear();
+                    if (!*j)
+                        break;
+                }
+                else
+                    tmp += *j;
+        }
+        else {
+            std::cerr << "[ERROR] Unknown option '" << opt << '\'' << std::endl;
+            return 1;
+        }
+    }
 
-    // Analyzing
-    analyze();
+    if (operf)
+        perfOpen();
 
-    return 0;
+    // PLA input
+    if (ipla.size()) {
+        if (!pla())
+            return 1;
+    }
+    else {
+        // Input expression
+        std::cout << "Input expression: ";
+        std::cin >> input;
+
+        // Validating
+        if (!validate())
+            return 0;
+
+        // Analyzing
+        analyze();
+    }
+
+    // Statistics
+    if (ostats)
+        report();
+    if (otrace.size())
+        traceOut();
+    return check() ? 0 : 1;
+}
+
+// Open phase
+Phase::Phase(const char* name, int idx, bool nalloc): prv(cph.load()), ts(otrace.size() ? tnow() : 0) {
+    char buf[sizeof(phs[0].name)];
+    if (idx < 0)
+        std::snprintf(buf, sizeof(buf), "%s", name);
+    else
+        std::snprintf(buf, sizeof(buf), "%s %d", name, idx);
+    // Find slot, phases with same name accumulate
+    for (id = 0; id < nph && std::strcmp(phs[id].name, buf); ++id);
+    if (id == nph) {
+        if (nph == MAXPH)
+            id = MAXPH - 1;
+        else {
+            ++nph;
+            std::strcpy(phs[id].name, buf);
+            for (auto &i : afree)
+                if (!std::strncmp(buf, i.c_str(), i.size()))
+                    nalloc = true;
+        }
+    }
+    phs[id].nalloc |= nalloc;
+    cph.store(id);
+    perfRead(ps);
+    st = std::chrono::steady_clock::now();
+}
+
+// Close phase
+Phase::~Phase() {
+    phs[id].ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - st).count();
+    uint64_t tmp[4];
+    perfRead(tmp);
+    for (int i = 0; i < 4; ++i)
+        phs[id].pc[i] += tmp[i] - ps[i];
+    cph.store(prv);
+    if (otrace.size())
+        trace(phs[id].name, -1, ts);
+}
+
+// Microseconds since start
+int64_t tnow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tst).count();
+}
+
+// Record span
+// Threads are numbered in order of their first event
+void trace(const char *name, int idx, int64_t ts) {
+    int64_t te = tnow();
+    std::lock_guard<std::mutex> lck(tmtx);
+    tev.push_back({name, idx, wid, ts, te - ts});
+}
+
+// Output trace file
+void traceOut() {
+    std::ofstream fout(otrace);
+    if (!fout) {
+        std::cerr << "[ERROR] Cannot write trace file '" << otrace << '\'' << std::endl;
+        return;
+    }
+    fout << "{\"traceEvents\":[";
+    for (size_t i = 0; i < tev.size(); ++i) {
+        if (i)
+            fout << ',';
+        fout << "\n{\"name\":\"" << tev[i].name;
+        if (tev[i].idx >= 0)
+            fout << ' ' << tev[i].idx;
+        fout << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tev[i].tid
+             << ",\"ts\":" << tev[i].ts << ",\"dur\":" << tev[i].dur << '}';
+    }
+    fout << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
+
+// Open hardware counters
+// Counters that are not permitted stay closed and are reported as '-'
+void perfOpen() {
+#ifdef __linux__
+    static const uint64_t cfg[4] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    int err = 0;
+    for (int i = 0; i < 4; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = cfg[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Count worker threads as well
+        attr.inherit = 1;
+        pfd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (pfd[i] < 0)
+            err = errno;
+    }
+    if (err)
+        std::cerr << "[WARN] Some performance counters are unavailable: " << std::strerror(err) << std::endl;
+#else
+    std::cerr << "[WARN] Performance counters are only supported on Linux" << std::endl;
+#endif
+}
+
+// Read hardware counters
+void perfRead(uint64_t *v) {
+    for (int i = 0; i < 4; ++i) {
+        v[i] = 0;
+#ifdef __linux__
+        if (pfd[i] >= 0 && read(pfd[i], v + i, sizeof(uint64_t)) != sizeof(uint64_t))
+            v[i] = 0;
+#endif
+    }
+}
+
+// Output statistics
+void report() {
+    std::fprintf(stderr, "[STATS] %-16s %12s %10s %12s", "phase", "time(ms)", "allocs", "bytes");
+    if (operf)
+        std::fprintf(stderr, " %14s %14s %6s %12s %12s", "cycles", "instructions", "IPC", "cache-miss", "branch-miss");
+    std::fputc('\n', stderr);
+    for (int i = 0; i < nph; ++i) {
+#ifdef QMA_ALLOC_TRACK
+        std::fprintf(stderr, "[STATS] %-16s %12.3f %10zu %12zu", phs[i].name, phs[i].ms, phs[i].allocs.load(), phs[i].bytes.load());
+#else
+        std::fprintf(stderr, "[STATS] %-16s %12.3f %10s %12s", phs[i].name, phs[i].ms, "-", "-");
+#endif
+        if (operf) {
+            char buf[4][24], ipc[16];
+            for (int j = 0; j < 4; ++j)
+                if (pfd[j] >= 0)
+                    std::snprintf(buf[j], sizeof(buf[j]), "%llu", (unsigned long long)phs[i].pc[j]);
+                else
+                    std::strcpy(buf[j], "-");
+            if (pfd[0] >= 0 && pfd[1] >= 0 && phs[i].pc[0])
+                std::snprintf(ipc, sizeof(ipc), "%.2f", (double)phs[i].pc[1] / phs[i].pc[0]);
+            else
+                std::strcpy(ipc, "-");
+            std::fprintf(stderr, " %14s %14s %6s %12s %12s", buf[0], buf[1], ipc, buf[2], buf[3]);
+        }
+        std::fputc('\n', stderr);
+    }
+    for (auto &i : notes)
+        std::fprintf(stderr, "[STATS] %s\n", i.c_str());
+    if (obound)
+        std::fprintf(stderr, "[STATS] cover %zu terms, lower bound %.0f, gap %.1f%%\n",
+                     bterms, blb, bterms ? (bterms - blb) * 100.0 / bterms : 0.0);
+}
+
+// Clear statistics
+void clearStats() {
+    for (int i = 0; i < nph; ++i) {
+        phs[i].name[0] = 0;
+        phs[i].nalloc = false;
+        phs[i].allocs = phs[i].bytes = 0;
+        phs[i].ms = 0;
+        std::memset(phs[i].pc, 0, sizeof(phs[i].pc));
+    }
+    nph = 0;
+    notes.clear();
+}
+
+// Check phases that must not allocate
+bool check() {
+    if (afree.empty())
+        return true;
+#ifdef QMA_ALLOC_TRACK
+    bool rtn = true;
+    for (int i = 0; i < nph; ++i)
+        if (phs[i].nalloc && phs[i].allocs.load()) {
+            std::cerr << "[ERROR] Phase '" << phs[i].name << "' allocated " << phs[i].allocs.load() << " blocks (" << phs[i].bytes.load() << " bytes)" << std::endl;
+            rtn = false;
+        }
+    return rtn;
+#else
+    std::cerr << "[ERROR] Allocation check needs a build with -DQMA_ALLOC_TRACK" << std::endl;
+    return false;
+#endif
 }
 
 // Validate input
@@ -96,7 +595,15 @@ bool validate() {
     return true;
 }
 
+// Projection masks
+// Bits of a 64-minterm word where variable i (0..5) is 1
+const uint64_t prj[6] = {
+    0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+    0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull
+};
+
 // Abstract syntax tree node
+// get() evaluates one row, word() the 64 rows of a bitmap word at once
 class OpNode {
     public:
         OpNode *l, *r;
@@ -108,58 +615,81 @@ class OpNode {
             if (r) delete r;
         }
         OpNode& operator=(const OpNode&) = delete;
-        virtual int get() = 0;
+        virtual int get(size_t x) = 0;
+        virtual uint64_t word(size_t w) = 0;
 };
 
 // Root node
 class RootNode: public OpNode {
     public:
-        int get() {
-            return l->get();
+        int get(size_t x) {
+            return l->get(x);
+        }
+        uint64_t word(size_t w) {
+            return l->word(w);
         }
 };
 
 // Variable node
+// Reads its value from the row index, so evaluation is thread-safe
 class VarNode: public OpNode {
     private:
         char cvar;
+        int sft;
 
     public:
-        VarNode(char c = 1): cvar(c) {}
-        int get() {
-            return cvar < 2 ? cvar : mvar[cvar];
+        VarNode(char c = 1): cvar(c), sft(c < 2 ? 0 : mvar.at(c)) {}
+        int get(size_t x) {
+            return cvar < 2 ? cvar : (x >> sft) & 1;
+        }
+        uint64_t word(size_t w) {
+            if (cvar < 2)
+                return cvar ? ~0ull : 0;
+            return sft < 6 ? prj[sft] : (w >> (sft - 6)) & 1 ? ~0ull : 0;
         }
 };
 
 // NOT Node
 class NotNode: public OpNode {
     public:
-        int get() {
-            return l->get() ^ 1;
+        int get(size_t x) {
+            return l->get(x) ^ 1;
+        }
+        uint64_t word(size_t w) {
+            return ~l->word(w);
         }
 };
 
 // AND Node
 class AndNode: public OpNode {
     public:
-        int get() {
-            return l->get() & r->get();
+        int get(size_t x) {
+            return l->get(x) & r->get(x);
+        }
+        uint64_t word(size_t w) {
+            return l->word(w) & r->word(w);
         }
 };
 
 // OR Node
 class OrNode: public OpNode {
     public:
-        int get() {
-            return l->get() | r->get();
+        int get(size_t x) {
+            return l->get(x) | r->get(x);
+        }
+        uint64_t word(size_t w) {
+            return l->word(w) | r->word(w);
         }
 };
 
 // XOR Node
 class XorNode: public OpNode {
     public:
-        int get() {
-            return l->get() ^ r->get();
+        int get(size_t x) {
+            return l->get(x) ^ r->get(x);
+        }
+        uint64_t word(size_t w) {
+            return l->word(w) ^ r->word(w);
         }
 };
 
@@ -238,234 +768,2601 @@ std::string cvtRPN(const std::string& expr) {
 // Output true value table
 // O(N*2^N)
 void tvt() {
+    Phase ph("tvt");
     // Output title
-    for (auto &i : var)
-        std::cout << i << ' ';
-    std::cout << "| Y" << std::endl;
+    if (otable) {
+        for (auto &i : var)
+            std::cout << i << ' ';
+        std::cout << "| Y" << std::endl;
+    }
+    // Evaluate 64 rows per word in parallel, chunks own disjoint words of the bitmap
+    const size_t CHK = 64;
+    size_t lmt = (size_t)1 << var.size();
+    on.assign((lmt + 63) / 64, 0);
+    pfor((on.size() + CHK - 1) / CHK, [&](size_t c) {
+        Span sp("tvt chunk", c);
+        for (size_t w = c * CHK; w < on.size() && w < (c + 1) * CHK; ++w)
+            on[w] = root.word(w);
+    });
+    if (lmt < 64)
+        on[0] &= (1ull << lmt) - 1;
     // Output table
-    for (size_t i = 0, lmt = (1 << var.size()); i < lmt; ++i) {
-        for (int j = var.size() - 1; j >= 0; --j)
-            std::cout << ((i >> j) & 1) << ' ';
-        int cnt = var.size() - 1;
-        for (auto &j : var) {
-            mvar[j] = ((i >> cnt) & 1);
-            --cnt;
-        }
-        int ans = root.get();
+    for (size_t i = 0; i < lmt; ++i) {
+        int ans = (on[i >> 6] >> (i & 63)) & 1;
         if (ans)
             m.emplace_back(i);
-        std::cout << "| " << ans << std::endl;
+        if (otable) {
+            for (int j = var.size() - 1; j >= 0; --j)
+                std::cout << ((i >> j) & 1) << ' ';
+            std::cout << "| " << ans << std::endl;
+        }
     }
 }
 
-// Get 1 count
-// O(N)
-int count1(const std::string& str) {
-    int rtn = 0;
-    for (auto &i : str)
-        if (i == '1')
-            ++rtn;
-    return rtn;
+// Worker pool
+// othreads - 1 threads started on first use and restarted only when othreads changes, so
+// pool thread i stays worker i. A job runs on all of them and the calling thread
+class Pool {
+    private:
+        std::vector<std::thread> ths;
+        std::mutex mtx;
+        std::condition_variable wcv, dcv;
+        const std::function<void(size_t)> *job = nullptr;
+        size_t n = 0, gen = 0, act = 0;
+        std::atomic<size_t> nxt{0};
+        bool stp = false;
+
+        void run() {
+            for (size_t i; (i = nxt++) < n; )
+                (*job)(i);
+        }
+        void loop(int id) {
+            wid = id;
+            for (size_t sen = 0; ; ) {
+                std::unique_lock<std::mutex> lck(mtx);
+                wcv.wait(lck, [&]() {
+                    return stp || gen != sen;
+                });
+                if (stp)
+                    return;
+                sen = gen;
+                lck.unlock();
+                run();
+                lck.lock();
+                if (!--act)
+                    dcv.notify_one();
+            }
+        }
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lck(mtx);
+                stp = true;
+            }
+            wcv.notify_all();
+            for (auto &i : ths)
+                i.join();
+            ths.clear();
+            stp = false;
+        }
+
+    public:
+        bool busy = false;
+
+        ~Pool() {
+            stop();
+        }
+        void exec(size_t tc, size_t cnt, const std::function<void(size_t)>& f) {
+            if (ths.size() + 1 != tc) {
+                stop();
+                for (size_t i = 1; i < tc; ++i)
+                    ths.emplace_back(&Pool::loop, this, (int)i);
+            }
+            {
+                std::lock_guard<std::mutex> lck(mtx);
+                job = &f;
+                n = cnt;
+                nxt = 0;
+                act = ths.size();
+                ++gen;
+            }
+            wcv.notify_all();
+            run();
+            std::unique_lock<std::mutex> lck(mtx);
+            dcv.wait(lck, [&]() {
+                return !act;
+            });
+            job = nullptr;
+        }
+} pool;
+
+// Parallel for
+// Runs f(0..n-1) on the pool, indices are handed out dynamically. Nested calls, and calls
+// from pool threads, run inline
+void pfor(size_t n, const std::function<void(size_t)>& f) {
+    if (othreads <= 1 || n <= 1 || wid || pool.busy) {
+        for (size_t i = 0; i < n; ++i)
+            f(i);
+        return;
+    }
+    pool.busy = true;
+    pool.exec(othreads, n, f);
+    pool.busy = false;
 }
 
-// Get prime list
-std::vector<std::string>
-gpl(const std::vector<std::string>& ls,
-    std::unordered_map<std::string, std::unordered_set<size_t>>& st) {
-    std::unordered_map<size_t, std::unordered_set<std::string>> cnt;
-    std::vector<std::string> rtn;
-    // Count element
-    for (auto &i : ls)
-        for (auto &j : st.at(i))
-            cnt[j].emplace(i);
-    // Simplify
-    // O(N)
-    while (cnt.size()) {
-        size_t mn = ~0ull;
-        int mns;
-        // Find min element count
-        for (auto &i : cnt)
-            if (i.second.size() < mn) {
-                mn = i.second.size();
-                mns = i.first;
-            }
-        // Find max element set
-        mn = 0;
-        std::string ms;
-        for (auto &i : cnt[mns])
-            if (st[i].size() > mn) {
-                mn = st[i].size();
-                ms = i;
-            }
-        rtn.emplace_back(ms);
-        // Delete
-        for (auto &i : st[ms]) {
-            for (auto &j : st)
-                if (j.first != ms)
-                    j.second.erase(i);
-            cnt.erase(i);
-        }
-        st[ms].clear();
+// Cube
+// Bit i of c is set if variable i (row bit i) is a literal, v holds the literal values
+struct Cube {
+    uint32_t v, c;
+};
+
+// Cube from string, the first character is the highest bit
+Cube toCube(const std::string& str) {
+    Cube rtn = {0, 0};
+    for (auto &i : str) {
+        rtn.v <<= 1;
+        rtn.c <<= 1;
+        if (i != '-') {
+            rtn.c |= 1;
+            rtn.v |= i == '1';
+        }
     }
     return rtn;
 }
 
-// Quine-McCluskey Algorithm
-// O(N^2)
-std::vector<std::string> QMA() {
-    std::vector<std::string> ls, tls;
-    std::unordered_map<std::string, std::unordered_set<size_t>> st;
-    // Convert to string
-    for (auto &i : m) {
-        std::string tmp;
-        for (int j = var.size() - 1; j >= 0; --j)
-            tmp += ((i >> j) & 1) + '0';
-        ls.emplace_back(tmp);
-        st[tmp].emplace(i);
+// Cube to string
+std::string toStr(const Cube& x, int n) {
+    std::string rtn(n, '-');
+    for (int i = 0; i < n; ++i)
+        if ((x.c >> i) & 1)
+            rtn[n - 1 - i] = '0' + ((x.v >> i) & 1);
+    return rtn;
+}
+
+// Single-cube containment
+// a covers b if its literals are a subset of b's and agree on them
+bool covers(const Cube& a, const Cube& b) {
+    return !(a.c & ~b.c) && !((a.v ^ b.v) & a.c);
+}
+
+// Absorption
+// Drop cubes covered by another cube (and duplicates), keeping the order of the rest
+// Cubes are visited by literal count, and only kept masks that are subsets are probed,
+// O(M*K) for K distinct masks instead of O(K^2)
+void absorb(std::vector<Cube>& cs) {
+    std::vector<size_t> ord(cs.size());
+    for (size_t i = 0; i < ord.size(); ++i)
+        ord[i] = i;
+    std::sort(ord.begin(), ord.end(), [&](size_t a, size_t b) {
+        int pa = __builtin_popcount(cs[a].c), pb = __builtin_popcount(cs[b].c);
+        return pa != pb ? pa < pb : a < b;
+    });
+    std::unordered_map<uint32_t, std::unordered_set<uint32_t>> grp;
+    std::vector<uint32_t> msk;
+    std::vector<char> kp(cs.size(), 0);
+    for (auto &i : ord) {
+        auto &x = cs[i];
+        bool cov = false;
+        for (size_t j = 0; !cov && j < msk.size(); ++j)
+            cov = !(msk[j] & ~x.c) && grp[msk[j]].count(x.v & msk[j]);
+        if (cov)
+            continue;
+        kp[i] = 1;
+        auto it = grp.find(x.c);
+        if (it == grp.end()) {
+            msk.emplace_back(x.c);
+            it = grp.emplace(x.c, std::unordered_set<uint32_t>()).first;
+        }
+        it->second.emplace(x.v & x.c);
     }
-    // Merge
-    // O(N^2)
-    bool f = false;
-    std::unordered_map<int, std::vector<std::string>> grp;
-    std::unordered_map<std::string, bool> chk;
-    do {
-        chk.clear();
-        tls.clear();
-        grp.clear();
-        f = false;
-        int mx = -1;
-        // Grouping
-        for (auto &i : ls) {
-            int tmp = count1(i);
-            grp[tmp].emplace_back(i);
-            if (tmp > mx)
-                mx = tmp;
-        }
-        // Compare with adjacent group
-        for (size_t i = 1; i <= mx; ++i)
-            if (grp[i].size() && grp[i - 1].size())
-                for (auto &j : grp[i])
-                    for (auto &k : grp[i - 1]) {
-                        std::string tmp;
-                        int cnt = 0;
-                        for (size_t l = 0; cnt < 2 && l < j.size(); ++l)
-                            if (j[l] != k[l]) {
-                                tmp += '-';
-                                ++cnt;
-                            }
-                            else 
-                                tmp += j[l];
-                        if (cnt != 1)
-                            continue;
-                        if (st.find(tmp) == st.end()) {
-                            st[tmp] = st[j];
-                            for (auto &_ : st[k])
-                                st[tmp].emplace(_);
-                            tls.emplace_back(tmp);
-                        }
-                        chk[j] = chk[k] = true;
-                        f = true;
-                    }
-        for (auto &i : ls)
-            if (!chk[i])
-                tls.emplace_back(i);
-        ls.swap(tls);
-    } while (f);
-    return gpl(ls, st);
+    size_t cnt = 0;
+    for (size_t i = 0; i < cs.size(); ++i)
+        if (kp[i])
+            cs[cnt++] = cs[i];
+    cs.resize(cnt);
 }
 
-// Assert
-void ast(const std::string& err, std::stack<OpNode*>& stk) {
-    // Clear stack
-    while (!stk.empty()) {
-        delete stk.top();
-        stk.pop();
+// Enumerate minterms of cube
+// O(2^F), F denotes the number of free variables
+template<class F>
+void forEach(const Cube& x, int n, F f) {
+    uint32_t fre = ~x.c & (uint32_t)(((uint64_t)1 << n) - 1);
+    for (uint32_t s = 0; ; s = (s - fre) & fre) {
+        f((size_t)(x.v | s));
+        if (((s - fre) & fre) == 0)
+            break;
     }
-    // Output error
-    std::cerr << err << std::endl;
 }
 
-// Analyze
-void analyze() {
-    // Get reverse polish notation
-    std::string rpn = cvtRPN(cvtAL(input));
-    if (rpn[0] == '[') {
-        std::cerr << rpn << std::endl;
+// Bitmap test
+inline bool bit(const std::vector<uint64_t>& b, size_t i) {
+    return (b[i >> 6] >> (i & 63)) & 1;
+}
+
+// Rank of set bits
+// Maps ON minterms to dense indices
+class Rank {
+    private:
+        const std::vector<uint64_t> &b;
+        std::vector<size_t> rk;
+
+    public:
+        Rank(const std::vector<uint64_t>& b): b(b), rk(b.size() + 1, 0) {
+            for (size_t i = 0; i < b.size(); ++i)
+                rk[i + 1] = rk[i] + __builtin_popcountll(b[i]);
+        }
+        size_t operator()(size_t j) const {
+            return rk[j >> 6] + __builtin_popcountll(b[j >> 6] & ((1ull << (j & 63)) - 1));
+        }
+        size_t size() const {
+            return rk.back();
+        }
+};
+
+// Low variable pattern
+// Bits of a 64-minterm word inside the cube, for variables 0..5
+inline uint64_t lpat(const Cube& x) {
+    uint64_t rtn = ~0ull;
+    for (uint32_t c = x.c & 63; c; c &= c - 1) {
+        int i = __builtin_ctz(c);
+        rtn &= (x.v >> i) & 1 ? prj[i] : ~prj[i];
+    }
+    return rtn;
+}
+
+// Visit words of cube
+// f(word index, pattern); words are the high variables' free combinations
+template<class F>
+inline void forWords(const Cube& x, int n, F f) {
+    uint64_t pat = lpat(x);
+    if (n <= 6) {
+        f(0, pat & (n == 6 ? ~0ull : (1ull << (1 << n)) - 1));
         return;
     }
-    // Get abstract syntax tree
-    std::stack<OpNode*> stk;
-    auto errout = std::bind(ast, std::placeholders::_1, stk);
-    for (auto &i : rpn)
-        if (isupper(i))
-            stk.emplace(new VarNode(i));
-        else if (isdigit(i))
-            stk.emplace(new VarNode(i - '0'));
-        else if (i == '\'') {
-            if (stk.size() < 1) {
-                errout("[ERROR] Invalid NOT logic");
-                return;
+    uint32_t hv = x.v >> 6, fh = ~(x.c >> 6) & ((1u << (n - 6)) - 1);
+#ifdef __BMI2__
+    for (uint32_t k = 0, lmt = 1u << __builtin_popcount(fh); k < lmt; ++k)
+        f(hv | _pdep_u32(k, fh), pat);
+#else
+    for (uint32_t s = 0; ; s = (s - fh) & fh) {
+        f(hv | s, pat);
+        if (((s - fh) & fh) == 0)
+            break;
+    }
+#endif
+}
+
+// Count set bits of bitmap inside cube
+// O(2^F/64) for F free variables
+inline size_t ccount(const Cube& x, int n, const std::vector<uint64_t>& b) {
+    size_t rtn = 0;
+    forWords(x, n, [&](size_t w, uint64_t p) {
+        rtn += __builtin_popcountll(b[w] & p);
+    });
+    return rtn;
+}
+
+// Clear bits of bitmap inside cube
+inline void cclear(const Cube& x, int n, std::vector<uint64_t>& b) {
+    forWords(x, n, [&](size_t w, uint64_t p) {
+        b[w] &= ~p;
+    });
+}
+
+// Get prime list
+// Primes are scored by intersecting them with the uncovered bitmap, only a dense
+// count of covering primes is kept per ON minterm
+std::vector<Cube> gpl(int n, const std::vector<Cube>& ls, const std::vector<uint64_t>& onb) {
+    Phase ph("cover");
+    std::vector<Cube> rtn;
+    std::vector<uint64_t> unc(onb);
+    // Count primes per ON minterm
+    Rank rank(onb);
+    std::vector<uint32_t> cnt(rank.size(), 0);
+    for (auto &i : ls)
+        forEach(i, n, [&](size_t j) {
+            if (bit(onb, j))
+                ++cnt[rank(j)];
+        });
+    // Simplify
+    int itr = 0;
+    for (size_t rem = rank.size(); rem; ) {
+        Span sp("cover iter", itr++);
+        size_t mn = ~0ull, mns = 0;
+        // Find uncovered minterm with min prime count
+        for (size_t w = 0; w < unc.size(); ++w)
+            for (uint64_t x = unc[w]; x; x &= x - 1) {
+                size_t j = w * 64 + __builtin_ctzll(x);
+                if (cnt[rank(j)] < mn) {
+                    mn = cnt[rank(j)];
+                    mns = j;
+                }
             }
-            NotNode *tmp = new NotNode();
-            tmp->l = stk.top();
-            stk.pop();
-            stk.emplace(tmp);
+        // Find prime covering most uncovered minterms
+        Cube x = {(uint32_t)mns, ~0u};
+        size_t ms = 0;
+        mn = 0;
+        for (size_t i = 0; i < ls.size(); ++i)
+            if (covers(ls[i], x)) {
+                size_t tmp = ccount(ls[i], n, unc);
+                if (tmp > mn) {
+                    mn = tmp;
+                    ms = i;
+                }
+            }
+        rtn.emplace_back(ls[ms]);
+        rem -= mn;
+        cclear(ls[ms], n, unc);
+    }
+    return rtn;
+}
+
+// Chvatal greedy cover
+// Repeatedly take the prime covering most uncovered minterms per cost (literals + 1).
+// Gains only shrink, so a popped prime is rescored and accepted only if its score still holds
+// O(P*logP) heap operations instead of rescanning all minterms per step
+std::vector<Cube> chv(int n, const std::vector<Cube>& ls, const std::vector<uint64_t>& onb) {
+    Phase ph("cover");
+    std::vector<Cube> rtn;
+    std::vector<uint64_t> unc(onb);
+    size_t rem = 0;
+    for (auto &i : unc)
+        rem += __builtin_popcountll(i);
+    auto gain = [&](const Cube& x) {
+        return ccount(x, n, unc);
+    };
+    // Entry: gain, cost, prime
+    typedef std::tuple<size_t, size_t, size_t> Ent;
+    auto cmp = [](const Ent& a, const Ent& b) {
+        size_t l = std::get<0>(a) * std::get<1>(b), r = std::get<0>(b) * std::get<1>(a);
+        if (l != r)
+            return l < r;
+        if (std::get<1>(a) != std::get<1>(b))
+            return std::get<1>(a) > std::get<1>(b);
+        return std::get<2>(a) > std::get<2>(b);
+    };
+    std::priority_queue<Ent, std::vector<Ent>, decltype(cmp)> pq(cmp);
+    for (size_t i = 0; i < ls.size(); ++i) {
+        size_t g = gain(ls[i]);
+        if (g)
+            pq.emplace(g, __builtin_popcount(ls[i].c) + 1, i);
+    }
+    int itr = 0;
+    while (rem && pq.size()) {
+        Ent top = pq.top();
+        pq.pop();
+        size_t g = gain(ls[std::get<2>(top)]);
+        if (!g)
+            continue;
+        if (g != std::get<0>(top)) {
+            std::get<0>(top) = g;
+            pq.push(top);
+            continue;
         }
-        else if (i == '*') {
-            if (stk.size() < 2) {
-                errout("[ERROR] Invalid AND logic");
-                return;
+        Span sp("cover iter", itr++);
+        auto &x = ls[std::get<2>(top)];
+        rtn.emplace_back(x);
+        cclear(x, n, unc);
+        rem -= g;
+    }
+    return rtn;
+}
+
+// Local search
+// Simulated annealing over prime selections: drop one or two primes, repair greedily (or randomly)
+// from the primes covering the first uncovered minterm and remove redundant primes. Only valid
+// covers are ever formed; the best one, by terms then literals, is kept
+void improve(int n, const std::vector<Cube>& ls, const std::vector<uint64_t>& onb, std::vector<Cube>& cv, double ms) {
+    Phase ph("improve");
+    auto st = std::chrono::steady_clock::now();
+    std::mt19937_64 rng(1);
+    // Cover counts per ON minterm rank
+    Rank rank(onb);
+    std::vector<uint32_t> cnt(rank.size(), 0);
+    auto add = [&](const Cube& x, int d, std::vector<size_t> *unc) {
+        forEach(x, n, [&](size_t j) {
+            if (bit(onb, j)) {
+                uint32_t &c = cnt[rank(j)];
+                c += d;
+                if (!c && unc)
+                    unc->emplace_back(j);
             }
-            AndNode *tmp = new AndNode();
-            tmp->l = stk.top();
-            stk.pop();
-            tmp->r = stk.top();
-            stk.pop();
-            stk.emplace(tmp);
+        });
+    };
+    auto cost = [&](const std::vector<Cube>& c) {
+        size_t lit = 0;
+        for (auto &i : c)
+            lit += __builtin_popcount(i.c);
+        return std::make_pair(c.size(), lit);
+    };
+    // Remove redundant primes, most literals first
+    auto irr = [&](std::vector<Cube>& c) {
+        std::stable_sort(c.begin(), c.end(), [](const Cube& a, const Cube& b) {
+            return __builtin_popcount(a.c) > __builtin_popcount(b.c);
+        });
+        for (size_t i = 0; i < c.size(); ) {
+            bool red = true;
+            forEach(c[i], n, [&](size_t j) {
+                if (bit(onb, j) && cnt[rank(j)] < 2)
+                    red = false;
+            });
+            if (red) {
+                add(c[i], -1, nullptr);
+                c.erase(c.begin() + i);
+            }
+            else
+                ++i;
         }
-        else if (i == '^') {
-            if (stk.size() < 2) {
-                errout("[ERROR] Invalid XOR logic");
-                return;
+    };
+    for (auto &i : cv)
+        add(i, 1, nullptr);
+    irr(cv);
+    auto cur = cv;
+    auto cc = cost(cur), bc = cc;
+    int itr = 0;
+    for (double el; (el = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - st).count()) < ms && cur.size() > 1; ) {
+        Span sp("improve iter", itr++);
+        double tmp = 1 - el / ms;
+        auto nxt = cur;
+        std::vector<size_t> unc;
+        // Drop
+        for (int k = 1 + rng() % 2; k && nxt.size(); --k) {
+            size_t i = rng() % nxt.size();
+            add(nxt[i], -1, &unc);
+            nxt.erase(nxt.begin() + i);
+        }
+        // Repair
+        for (size_t u = 0; u < unc.size(); ++u) {
+            size_t j = unc[u];
+            if (cnt[rank(j)])
+                continue;
+            Cube x = {(uint32_t)j, ~0u};
+            std::vector<size_t> cds;
+            for (size_t i = 0; i < ls.size(); ++i)
+                if (covers(ls[i], x))
+                    cds.emplace_back(i);
+            size_t pk = cds[rng() % cds.size()];
+            if (rng() % 2) {
+                size_t bg = 0;
+                for (auto &i : cds) {
+                    size_t g = 0;
+                    forEach(ls[i], n, [&](size_t k) {
+                        g += bit(onb, k) && !cnt[rank(k)];
+                    });
+                    if (g > bg) {
+                        bg = g;
+                        pk = i;
+                    }
+                }
             }
-            XorNode *tmp = new XorNode();
-            tmp->l = stk.top();
-            stk.pop();
-            tmp->r = stk.top();
-            stk.pop();
-            stk.emplace(tmp);
+            nxt.emplace_back(ls[pk]);
+            add(ls[pk], 1, nullptr);
         }
-        else if (i == '+') {
-            if (stk.size() < 2) {
-                errout("[ERROR] Invalid OR logic");
-                return;
+        irr(nxt);
+        // Accept
+        auto nc = cost(nxt);
+        double dlt = ((double)nc.first - cc.first) * (n + 1) + ((double)nc.second - cc.second);
+        if (dlt <= 0 || (tmp > 0 && (rng() >> 11) * (1.0 / 9007199254740992.0) < std::exp(-dlt / (tmp * 2)))) {
+            cur.swap(nxt);
+            cc = nc;
+            if (cc < bc) {
+                bc = cc;
+                cv = cur;
             }
-            OrNode *tmp = new OrNode();
-            tmp->l = stk.top();
-            stk.pop();
-            tmp->r = stk.top();
-            stk.pop();
-            stk.emplace(tmp);
         }
         else {
-            errout("[ERROR] Invalid logic");
-            return;
+            for (auto &i : nxt)
+                add(i, -1, nullptr);
+            for (auto &i : cur)
+                add(i, 1, nullptr);
         }
-    if (stk.size() > 1) {
-        errout("[ERROR] Invalid logic");
-        return;
-    }
-    root.l = stk.top();
-    std::cout << std::endl;
-    // If is constant expression
-    if (var.size() == 0) {
-        std::cout << "Constant expression:\nY = " << root.get() << std::endl;
-        return;
     }
-    // Output true value table
+}
+
+// Covering matrix
+// Rows are ON minterms, columns are primes, cost orders by terms then literals
+struct Mat {
+    std::vector<Cube> col;
+    std::vector<uint64_t> cst;
+    std::vector<std::vector<uint32_t>> rc, cr;
+};
+
+// Column cost
+inline uint64_t cost(const Cube& x) {
+    return (1ull << 32) | __builtin_popcount(x.c);
+}
+
+// Build covering matrix
+Mat mkMat(int n, const std::vector<Cube>& prm, const std::vector<uint64_t>& onb) {
+    Rank rank(onb);
+    Mat rtn;
+    rtn.rc.resize(rank.size());
+    for (auto &i : prm) {
+        std::vector<uint32_t> rs;
+        forEach(i, n, [&](size_t j) {
+            if (bit(onb, j))
+                rs.emplace_back(rank(j));
+        });
+        if (rs.empty())
+            continue;
+        for (auto &j : rs)
+            rtn.rc[j].emplace_back(rtn.col.size());
+        rtn.col.emplace_back(i);
+        rtn.cst.emplace_back(cost(i));
+        rtn.cr.emplace_back(std::move(rs));
+    }
+    return rtn;
+}
+
+// Reduce covering matrix
+// Essential columns go to ess, dominated rows and columns are dropped, repeated until stable.
+// Dominance checks are skipped when their work estimate is too large
+Mat reduce(const Mat& a, std::vector<Cube>& ess) {
+    size_t R = a.rc.size(), C = a.col.size();
+    std::vector<char> ra(R, 1), ca(C, 1);
+    std::vector<uint32_t> mk(std::max(R, C), 0);
+    uint32_t stp = 0;
+    size_t wrk = 0;
+    for (auto &i : a.cr)
+        wrk += i.size() * i.size();
+    bool dom = wrk < 50000000;
+    for (bool chg = true; chg; ) {
+        chg = false;
+        // Essential columns
+        for (size_t r = 0; r < R; ++r) {
+            if (!ra[r])
+                continue;
+            size_t cnt = 0, lst = 0;
+            for (auto &c : a.rc[r])
+                if (ca[c]) {
+                    ++cnt;
+                    lst = c;
+                }
+            if (cnt != 1)
+                continue;
+            ess.emplace_back(a.col[lst]);
+            ca[lst] = 0;
+            for (auto &i : a.cr[lst])
+                ra[i] = 0;
+            chg = true;
+        }
+        if (!dom)
+            continue;
+        // Column dominance, c2 goes if some c1 covers all its rows at no more cost
+        for (size_t c2 = 0; c2 < C; ++c2) {
+            if (!ca[c2])
+                continue;
+            size_t r0 = R, nr = 0;
+            ++stp;
+            for (auto &r : a.cr[c2])
+                if (ra[r]) {
+                    mk[r] = stp;
+                    ++nr;
+                    if (r0 == R || a.rc[r].size() < a.rc[r0].size())
+                        r0 = r;
+                }
+            if (!nr) {
+                ca[c2] = 0;
+                chg = true;
+                continue;
+            }
+            for (auto &c1 : a.rc[r0]) {
+                if (c1 == c2 || !ca[c1] || a.cst[c1] > a.cst[c2])
+                    continue;
+                size_t hit = 0, tot = 0;
+                for (auto &r : a.cr[c1])
+                    if (ra[r]) {
+                        ++tot;
+                        hit += mk[r] == stp;
+                    }
+                if (hit == nr && (tot > nr || a.cst[c1] < a.cst[c2] || c1 < c2)) {
+                    ca[c2] = 0;
+                    chg = true;
+                    break;
+                }
+            }
+        }
+        // Row dominance, r1 goes if some r2 is covered only by columns that also cover r1
+        for (size_t r1 = 0; r1 < R; ++r1) {
+            if (!ra[r1])
+                continue;
+            size_t nc = 0;
+            ++stp;
+            for (auto &c : a.rc[r1])
+                if (ca[c]) {
+                    mk[c] = stp;
+                    ++nc;
+                }
+            bool rm = false;
+            for (size_t k = 0; !rm && k < a.rc[r1].size(); ++k) {
+                if (!ca[a.rc[r1][k]])
+                    continue;
+                for (auto &r2 : a.cr[a.rc[r1][k]]) {
+                    if (r2 == r1 || !ra[r2])
+                        continue;
+                    size_t hit = 0, tot = 0;
+                    for (auto &c : a.rc[r2])
+                        if (ca[c]) {
+                            ++tot;
+                            hit += mk[c] == stp;
+                        }
+                    if (hit == tot && (tot < nc || r2 < r1)) {
+                        rm = true;
+                        break;
+                    }
+                }
+            }
+            if (rm) {
+                ra[r1] = 0;
+                chg = true;
+            }
+        }
+    }
+    // Compact
+    Mat rtn;
+    std::vector<uint32_t> rid(R, 0), cid(C, 0);
+    size_t nr = 0;
+    for (size_t r = 0; r < R; ++r)
+        if (ra[r])
+            rid[r] = nr++;
+    rtn.rc.resize(nr);
+    for (size_t c = 0; c < C; ++c) {
+        if (!ca[c])
+            continue;
+        std::vector<uint32_t> rs;
+        for (auto &r : a.cr[c])
+            if (ra[r])
+                rs.emplace_back(rid[r]);
+        if (rs.empty())
+            continue;
+        for (auto &r : rs)
+            rtn.rc[r].emplace_back(rtn.col.size());
+        rtn.col.emplace_back(a.col[c]);
+        rtn.cst.emplace_back(a.cst[c]);
+        rtn.cr.emplace_back(std::move(rs));
+    }
+    return rtn;
+}
+
+// Greedy cover of matrix
+// Lazy heap on newly covered rows per cost, as chv()
+std::vector<uint32_t> mgreedy(const Mat& a) {
+    std::vector<uint32_t> rtn;
+    std::vector<char> cov(a.rc.size(), 0);
+    size_t rem = a.rc.size();
+    auto gain = [&](uint32_t c) {
+        size_t g = 0;
+        for (auto &r : a.cr[c])
+            g += !cov[r];
+        return g;
+    };
+    // Score is gain / literals+1, compared by cross multiplication
+    typedef std::pair<size_t, uint32_t> Ent;
+    auto cmp = [&](const Ent& x, const Ent& y) {
+        uint64_t cx = (a.cst[x.second] & 0xffffffff) + 1, cy = (a.cst[y.second] & 0xffffffff) + 1;
+        if (x.first * cy != y.first * cx)
+            return x.first * cy < y.first * cx;
+        return x.second > y.second;
+    };
+    std::priority_queue<Ent, std::vector<Ent>, decltype(cmp)> pq(cmp);
+    for (uint32_t c = 0; c < a.col.size(); ++c)
+        pq.emplace(a.cr[c].size(), c);
+    while (rem && pq.size()) {
+        Ent top = pq.top();
+        pq.pop();
+        size_t g = gain(top.second);
+        if (!g)
+            continue;
+        if (g != top.first) {
+            pq.emplace(g, top.second);
+            continue;
+        }
+        rtn.emplace_back(top.second);
+        for (auto &r : a.cr[top.second])
+            cov[r] = 1;
+        rem -= g;
+    }
+    return rtn;
+}
+
+// Branch-and-bound node
+struct Node {
+    std::vector<uint32_t> sel, pth;
+    std::vector<uint64_t> unc;
+    uint64_t cst;
+};
+
+// Exact cover of matrix
+// Branch on the uncovered row with fewest columns, bound by an independent row set.
+// Subtrees are tasks in per-worker deques: owners work depth-first from the back, idle workers
+// steal from the front. The incumbent cost is shared lock-free. Among equal covers the first in
+// sequential depth-first order wins, so ties are pruned only behind the incumbent's branch path
+// and the result doesn't depend on threads. After mxn nodes the search stops with the incumbent,
+// returns false if it isn't proven minimum
+bool exact(const Mat& a, std::vector<uint32_t>& rtn, int tc, size_t mxn) {
+    size_t R = a.rc.size(), W = (R + 63) / 64;
+    // Column masks
+    std::vector<std::vector<uint64_t>> cm(a.col.size(), std::vector<uint64_t>(W, 0));
+    for (size_t c = 0; c < a.col.size(); ++c)
+        for (auto &r : a.cr[c])
+            cm[c][r >> 6] |= 1ull << (r & 63);
+    // Columns of each row by cost
+    std::vector<std::vector<uint32_t>> rc(a.rc);
+    for (auto &i : rc)
+        std::sort(i.begin(), i.end(), [&](uint32_t x, uint32_t y) {
+            return a.cst[x] != a.cst[y] ? a.cst[x] < a.cst[y] : x < y;
+        });
+    // Incumbent from greedy
+    std::vector<uint32_t> bsel = mgreedy(a), bpth(1, ~0u);
+    uint64_t bc = 0;
+    for (auto &i : bsel)
+        bc += a.cst[i];
+    std::atomic<uint64_t> best(bc);
+    std::mutex bmtx;
+    // Work-stealing deques
+    tc = std::max(1, tc);
+    std::vector<std::deque<Node>> dq(tc);
+    std::vector<std::mutex> dmtx(tc);
+    std::atomic<size_t> pend(1), cnt(0);
+    std::atomic<bool> stp(false);
+    Node rt;
+    rt.unc.assign(W, 0);
+    for (size_t r = 0; r < R; ++r)
+        rt.unc[r >> 6] |= 1ull << (r & 63);
+    rt.cst = 0;
+    dq[0].push_back(std::move(rt));
+    auto expand = [&](int id, Node& nd) {
+        // Node limit, left nodes are dropped
+        if (cnt.fetch_add(1) >= mxn) {
+            stp = true;
+            return;
+        }
+        // Lower bound, rows sharing no column each need one more column
+        std::vector<char> used(a.col.size(), 0);
+        uint64_t lb = nd.cst;
+        size_t br = R, bn = ~(size_t)0;
+        for (size_t w = 0; w < W; ++w)
+            for (uint64_t x = nd.unc[w]; x; x &= x - 1) {
+                size_t r = w * 64 + __builtin_ctzll(x);
+                if (rc[r].size() < bn) {
+                    bn = rc[r].size();
+                    br = r;
+                }
+                bool ind = true;
+                for (auto &c : rc[r])
+                    if (used[c]) {
+                        ind = false;
+                        break;
+                    }
+                if (!ind)
+                    continue;
+                for (auto &c : rc[r])
+                    used[c] = 1;
+                lb += a.cst[rc[r][0]];
+            }
+        // Complete cover
+        if (br == R) {
+            std::lock_guard<std::mutex> lck(bmtx);
+            if (nd.cst < best.load() || (nd.cst == best.load() && nd.pth < bpth)) {
+                best.store(nd.cst);
+                bsel = nd.sel;
+                bpth = nd.pth;
+            }
+            return;
+        }
+        if (lb > best.load())
+            return;
+        if (lb == best.load()) {
+            std::lock_guard<std::mutex> lck(bmtx);
+            if (lb == best.load() && bpth < nd.pth)
+                return;
+        }
+        // Branch, cheapest column ends up on top of the deque
+        std::lock_guard<std::mutex> lck(dmtx[id]);
+        for (size_t k = rc[br].size(); k-- > 0; ) {
+            uint32_t c = rc[br][k];
+            if (nd.cst + a.cst[c] > best.load())
+                continue;
+            Node ch;
+            ch.sel = nd.sel;
+            ch.sel.emplace_back(c);
+            ch.pth = nd.pth;
+            ch.pth.emplace_back(k);
+            ch.unc = nd.unc;
+            for (size_t w = 0; w < W; ++w)
+                ch.unc[w] &= ~cm[c][w];
+            ch.cst = nd.cst + a.cst[c];
+            ++pend;
+            dq[id].push_back(std::move(ch));
+        }
+    };
+    auto wrk = [&](int id) {
+        Span sp("exact worker", id);
+        while (pend.load()) {
+            Node nd;
+            bool got = false;
+            {
+                std::lock_guard<std::mutex> lck(dmtx[id]);
+                if (dq[id].size()) {
+                    nd = std::move(dq[id].back());
+                    dq[id].pop_back();
+                    got = true;
+                }
+            }
+            for (int k = 1; !got && k < tc; ++k) {
+                int v = (id + k) % tc;
+                std::lock_guard<std::mutex> lck(dmtx[v]);
+                if (dq[v].size()) {
+                    nd = std::move(dq[v].front());
+                    dq[v].pop_front();
+                    got = true;
+                }
+            }
+            if (!got) {
+                std::this_thread::yield();
+                continue;
+            }
+            expand(id, nd);
+            --pend;
+        }
+    };
+    pfor(tc, [&](size_t i) {
+        wrk(i);
+    });
+    rtn = bsel;
+    return !stp;
+}
+
+// CDCL SAT solver
+// Two watched literals, first-UIP learning, VSIDS heap, phase saving, Luby restarts.
+// Literal 2v is variable v, 2v+1 its negation
+class Sat {
+    private:
+        std::vector<std::vector<int>> cls;
+        std::vector<std::vector<int>> wch;
+        std::vector<int8_t> val, phs;
+        std::vector<int> lvl, rsn, trl, lim, hp, pos;
+        std::vector<double> act;
+        double inc = 1;
+        size_t qh = 0;
+        bool bad = false;
+
+        int value(int l) const {
+            return val[l >> 1] < 0 ? -1 : val[l >> 1] ^ (l & 1);
+        }
+        void assign(int l, int r) {
+            val[l >> 1] = !(l & 1);
+            phs[l >> 1] = val[l >> 1];
+            lvl[l >> 1] = lim.size();
+            rsn[l >> 1] = r;
+            trl.emplace_back(l);
+        }
+        // Heap on activity
+        void up(int i) {
+            int v = hp[i];
+            for (; i && act[hp[(i - 1) / 2]] < act[v]; i = (i - 1) / 2) {
+                hp[i] = hp[(i - 1) / 2];
+                pos[hp[i]] = i;
+            }
+            hp[i] = v;
+            pos[v] = i;
+        }
+        void down(int i) {
+            int v = hp[i], n = hp.size();
+            for (int c; (c = 2 * i + 1) < n; i = c) {
+                if (c + 1 < n && act[hp[c + 1]] > act[hp[c]])
+                    ++c;
+                if (act[hp[c]] <= act[v])
+                    break;
+                hp[i] = hp[c];
+                pos[hp[i]] = i;
+            }
+            hp[i] = v;
+            pos[v] = i;
+        }
+        void push(int v) {
+            if (pos[v] >= 0)
+                return;
+            hp.emplace_back(v);
+            up(hp.size() - 1);
+        }
+        int pop() {
+            int v = hp[0];
+            hp[0] = hp.back();
+            hp.pop_back();
+            pos[v] = -1;
+            if (hp.size()) {
+                pos[hp[0]] = 0;
+                down(0);
+            }
+            return v;
+        }
+        void bump(int v) {
+            if ((act[v] += inc) > 1e100) {
+                for (auto &i : act)
+                    i *= 1e-100;
+                inc *= 1e-100;
+            }
+            if (pos[v] >= 0)
+                up(pos[v]);
+        }
+        // Returns conflicting clause or -1
+        int propagate() {
+            while (qh < trl.size()) {
+                int f = trl[qh++] ^ 1;
+                auto &ws = wch[f];
+                size_t j = 0;
+                for (size_t i = 0; i < ws.size(); ++i) {
+                    int ci = ws[i];
+                    auto &c = cls[ci];
+                    if (c[0] == f)
+                        std::swap(c[0], c[1]);
+                    if (value(c[0]) == 1) {
+                        ws[j++] = ci;
+                        continue;
+                    }
+                    bool fnd = false;
+                    for (size_t k = 2; k < c.size(); ++k)
+                        if (value(c[k]) != 0) {
+                            std::swap(c[1], c[k]);
+                            wch[c[1]].emplace_back(ci);
+                            fnd = true;
+                            break;
+                        }
+                    if (fnd)
+                        continue;
+                    ws[j++] = ci;
+                    if (value(c[0]) == 0) {
+                        for (++i; i < ws.size(); ++i)
+                            ws[j++] = ws[i];
+                        ws.resize(j);
+                        return ci;
+                    }
+                    assign(c[0], ci);
+                }
+                ws.resize(j);
+            }
+            return -1;
+        }
+        void backtrack(size_t l) {
+            if (lim.size() <= l)
+                return;
+            for (size_t i = trl.size(); i-- > (size_t)lim[l]; ) {
+                val[trl[i] >> 1] = -1;
+                push(trl[i] >> 1);
+            }
+            trl.resize(lim[l]);
+            lim.resize(l);
+            qh = trl.size();
+        }
+        // First UIP, returns learnt clause with asserting literal first
+        std::vector<int> analyze(int ci, size_t& bl) {
+            std::vector<int> lrn(1, 0);
+            std::vector<char> &see = seen;
+            int cnt = 0, p = -1;
+            size_t idx = trl.size();
+            do {
+                for (auto &q : cls[ci]) {
+                    if (q == p)
+                        continue;
+                    int v = q >> 1;
+                    if (see[v] || !lvl[v])
+                        continue;
+                    see[v] = 1;
+                    bump(v);
+                    if ((size_t)lvl[v] == lim.size())
+                        ++cnt;
+                    else
+                        lrn.emplace_back(q);
+                }
+                while (!see[trl[--idx] >> 1]);
+                p = trl[idx];
+                ci = rsn[p >> 1];
+                see[p >> 1] = 0;
+            } while (--cnt);
+            lrn[0] = p ^ 1;
+            bl = 0;
+            for (size_t i = 1; i < lrn.size(); ++i) {
+                see[lrn[i] >> 1] = 0;
+                if ((size_t)lvl[lrn[i] >> 1] > bl) {
+                    bl = lvl[lrn[i] >> 1];
+                    std::swap(lrn[1], lrn[i]);
+                }
+            }
+            inc *= 1 / 0.95;
+            return lrn;
+        }
+        std::vector<char> seen;
+
+    public:
+        int add() {
+            int v = val.size();
+            val.emplace_back(-1);
+            phs.emplace_back(0);
+            lvl.emplace_back(0);
+            rsn.emplace_back(-1);
+            act.emplace_back(0);
+            pos.emplace_back(-1);
+            seen.emplace_back(0);
+            wch.resize(2 * val.size());
+            push(v);
+            return v;
+        }
+        // Add clause at level 0
+        void clause(std::vector<int> c) {
+            if (bad)
+                return;
+            std::sort(c.begin(), c.end());
+            c.erase(std::unique(c.begin(), c.end()), c.end());
+            size_t j = 0;
+            for (size_t i = 0; i < c.size(); ++i) {
+                if (i + 1 < c.size() && (c[i] ^ 1) == c[i + 1])
+                    return;
+                if (value(c[i]) == 1)
+                    return;
+                if (value(c[i]) < 0)
+                    c[j++] = c[i];
+            }
+            c.resize(j);
+            if (c.empty())
+                bad = true;
+            else if (c.size() == 1) {
+                assign(c[0], -1);
+                bad = propagate() >= 0;
+            }
+            else {
+                wch[c[0]].emplace_back(cls.size());
+                wch[c[1]].emplace_back(cls.size());
+                cls.emplace_back(std::move(c));
+            }
+        }
+        // 1 satisfiable, 0 unsatisfiable, -1 conflict limit reached
+        int solve(size_t mxc) {
+            if (bad)
+                return 0;
+            size_t cfl = 0;
+            auto luby = [](size_t i) {
+                size_t k = 1;
+                while ((((size_t)1 << k) - 1) < i + 1)
+                    ++k;
+                while (i + 1 != ((size_t)1 << k) - 1) {
+                    i -= ((size_t)1 << (k - 1)) - 1;
+                    for (k = 1; (((size_t)1 << k) - 1) < i + 1; ++k);
+                }
+                return (size_t)1 << (k - 1);
+            };
+            for (size_t rs = 0; ; ++rs) {
+                size_t rlm = 100 * luby(rs), rc = 0;
+                while (true) {
+                    int ci = propagate();
+                    if (ci >= 0) {
+                        ++cfl;
+                        ++rc;
+                        if (lim.empty())
+                            return 0;
+                        size_t bl;
+                        auto lrn = analyze(ci, bl);
+                        backtrack(bl);
+                        if (lrn.size() == 1)
+                            assign(lrn[0], -1);
+                        else {
+                            wch[lrn[0]].emplace_back(cls.size());
+                            wch[lrn[1]].emplace_back(cls.size());
+                            cls.emplace_back(lrn);
+                            assign(lrn[0], cls.size() - 1);
+                        }
+                        if (cfl >= mxc) {
+                            backtrack(0);
+                            return -1;
+                        }
+                        continue;
+                    }
+                    if (rc >= rlm) {
+                        backtrack(0);
+                        break;
+                    }
+                    int v = -1;
+                    while (hp.size() && val[v = pop()] >= 0)
+                        v = -1;
+                    if (v < 0)
+                        return 1;
+                    lim.emplace_back(trl.size());
+                    assign(2 * v + !phs[v], -1);
+                }
+            }
+        }
+        bool model(int v) const {
+            return val[v] == 1;
+        }
+};
+
+// SAT-based exact cover
+// Is there a cover with at most k columns: row clauses plus a sequential counter.
+// k is binary searched between the independent row bound and the greedy cover; minimizes terms only.
+// A k hitting the conflict limit is treated as unsatisfiable and false is returned, the cover is then the best found
+bool satCover(const Mat& a, std::vector<uint32_t>& rtn, size_t mxc) {
+    size_t C = a.col.size();
+    rtn = mgreedy(a);
+    // Independent rows
+    size_t lo = 0;
+    std::vector<char> used(C, 0);
+    for (auto &r : a.rc) {
+        bool ind = true;
+        for (auto &c : r)
+            ind &= !used[c];
+        if (!ind)
+            continue;
+        for (auto &c : r)
+            used[c] = 1;
+        ++lo;
+    }
+    size_t hi = rtn.size();
+    bool prv = true;
+    while (lo < hi) {
+        size_t k = (lo + hi) / 2;
+        Span sp("sat k", k);
+        Sat sat;
+        for (size_t c = 0; c < C; ++c)
+            sat.add();
+        for (auto &r : a.rc) {
+            std::vector<int> cl;
+            for (auto &c : r)
+                cl.emplace_back(2 * c);
+            sat.clause(cl);
+        }
+        // s[i][j]: at least j+1 of the first i+1 columns are set
+        std::vector<std::vector<int>> s(C, std::vector<int>(std::max<size_t>(k, 1)));
+        for (size_t i = 0; i + 1 < C; ++i)
+            for (size_t j = 0; j < k; ++j)
+                s[i][j] = sat.add();
+        auto x = [](size_t c) {
+            return (int)(2 * c);
+        };
+        auto sv = [&](size_t i, size_t j) {
+            return 2 * s[i][j];
+        };
+        if (!k)
+            for (size_t c = 0; c < C; ++c)
+                sat.clause({x(c) ^ 1});
+        else {
+            sat.clause({x(0) ^ 1, sv(0, 0)});
+            for (size_t j = 1; j < k; ++j)
+                sat.clause({sv(0, j) ^ 1});
+            for (size_t i = 1; i + 1 < C; ++i) {
+                sat.clause({x(i) ^ 1, sv(i, 0)});
+                sat.clause({sv(i - 1, 0) ^ 1, sv(i, 0)});
+                for (size_t j = 1; j < k; ++j) {
+                    sat.clause({x(i) ^ 1, sv(i - 1, j - 1) ^ 1, sv(i, j)});
+                    sat.clause({sv(i - 1, j) ^ 1, sv(i, j)});
+                }
+                sat.clause({x(i) ^ 1, sv(i - 1, k - 1) ^ 1});
+            }
+            if (C > 1)
+                sat.clause({x(C - 1) ^ 1, sv(C - 2, k - 1) ^ 1});
+        }
+        int res = sat.solve(mxc);
+        if (res < 0) {
+            prv = false;
+            lo = k + 1;
+        }
+        else if (res) {
+            rtn.clear();
+            for (size_t c = 0; c < C; ++c)
+                if (sat.model(c))
+                    rtn.emplace_back(c);
+            hi = rtn.size();
+        }
+        else
+            lo = k + 1;
+    }
+    return prv;
+}
+
+// Lagrangian relaxation of set cover
+// Unit column costs, so the bound is on terms. Subgradient steps on the row multipliers;
+// every few steps a cover is built from the columns with lowest reduced cost per new row
+// and made irredundant, the best one is returned in sel. Returns the lower bound
+double lagr(const Mat& a, std::vector<uint32_t>& sel) {
+    size_t R = a.rc.size(), C = a.col.size();
+    std::vector<double> u(R), rdc(C), g(R);
+    for (size_t r = 0; r < R; ++r) {
+        size_t mx = 1;
+        for (auto &c : a.rc[r])
+            mx = std::max(mx, a.cr[c].size());
+        u[r] = 1.0 / mx;
+    }
+    sel = mgreedy(a);
+    double lb = 0, ub = sel.size(), lam = 2;
+    int stl = 0;
+    std::vector<uint32_t> cnt(R);
+    // Cover from reduced costs
+    auto heur = [&]() {
+        std::vector<uint32_t> cs;
+        std::fill(cnt.begin(), cnt.end(), 0);
+        for (size_t c = 0; c < C; ++c)
+            if (rdc[c] < 0) {
+                cs.emplace_back(c);
+                for (auto &r : a.cr[c])
+                    ++cnt[r];
+            }
+        for (size_t r = 0; r < R; ++r) {
+            if (cnt[r])
+                continue;
+            uint32_t bc = a.rc[r][0];
+            double bs = 1e300;
+            for (auto &c : a.rc[r]) {
+                size_t nw = 0;
+                for (auto &k : a.cr[c])
+                    nw += !cnt[k];
+                double sc = (std::max(rdc[c], 0.0) + 1e-9) / nw;
+                if (sc < bs) {
+                    bs = sc;
+                    bc = c;
+                }
+            }
+            cs.emplace_back(bc);
+            for (auto &k : a.cr[bc])
+                ++cnt[k];
+        }
+        // Irredundant, highest reduced cost first
+        std::sort(cs.begin(), cs.end(), [&](uint32_t x, uint32_t y) {
+            return rdc[x] != rdc[y] ? rdc[x] > rdc[y] : x < y;
+        });
+        std::vector<uint32_t> rtn;
+        for (size_t i = 0; i < cs.size(); ++i) {
+            bool red = true;
+            for (auto &r : a.cr[cs[i]])
+                red &= cnt[r] > 1;
+            if (red)
+                for (auto &r : a.cr[cs[i]])
+                    --cnt[r];
+            else
+                rtn.emplace_back(cs[i]);
+        }
+        return rtn;
+    };
+    for (int itr = 0; itr < 2000 && lam > 0.005 && std::ceil(lb - 1e-9) < ub; ++itr) {
+        // Lagrangian function
+        double lu = 0;
+        for (auto &i : u)
+            lu += i;
+        std::fill(g.begin(), g.end(), 1.0);
+        for (size_t c = 0; c < C; ++c) {
+            rdc[c] = 1;
+            for (auto &r : a.cr[c])
+                rdc[c] -= u[r];
+            if (rdc[c] < 0) {
+                lu += rdc[c];
+                for (auto &r : a.cr[c])
+                    g[r] -= 1;
+            }
+        }
+        if (lu > lb + 1e-9) {
+            lb = lu;
+            stl = 0;
+        }
+        else if (++stl >= 30) {
+            lam /= 2;
+            stl = 0;
+        }
+        if (itr % 10 == 0) {
+            auto tmp = heur();
+            if (tmp.size() < ub) {
+                ub = tmp.size();
+                sel = tmp;
+            }
+        }
+        // Subgradient step, rows that are over-covered with zero multiplier don't move
+        double nrm = 0;
+        for (size_t r = 0; r < R; ++r) {
+            if (g[r] < 0 && u[r] <= 0)
+                g[r] = 0;
+            nrm += g[r] * g[r];
+        }
+        if (nrm == 0)
+            break;
+        double stp = lam * (ub - lu) / nrm;
+        for (size_t r = 0; r < R; ++r)
+            u[r] = std::max(0.0, u[r] + stp * g[r]);
+    }
+    return std::ceil(lb - 1e-9);
+}
+
+// Generate primes
+// Cubes merge with the cube differing in one literal, found by hash lookup
+// O(M*N) per round, M denotes the number of cubes
+std::vector<Cube> gpr(int n, const std::vector<size_t>& ons, const std::vector<size_t>& dcs) {
+    std::vector<Cube> ls, tls;
+    uint32_t all = (uint32_t)(((uint64_t)1 << n) - 1);
+    for (auto &i : ons)
+        ls.push_back({(uint32_t)i, all});
+    for (auto &i : dcs)
+        ls.push_back({(uint32_t)i, all});
+    std::sort(ls.begin(), ls.end(), [](const Cube& a, const Cube& b) {
+        return a.v < b.v;
+    });
+    auto key = [](const Cube& x) {
+        return (uint64_t)x.c << 32 | x.v;
+    };
+    bool f = false;
+    int rnd = 0;
+    do {
+        Phase ph("merge", ++rnd);
+        f = false;
+        tls.clear();
+        std::unordered_map<uint64_t, size_t> idx;
+        for (size_t i = 0; i < ls.size(); ++i)
+            idx.emplace(key(ls[i]), i);
+        // Find pairs in parallel, apply them in cube order so the result doesn't depend on threads
+        const size_t CHK = 1024;
+        std::vector<std::vector<std::pair<size_t, size_t>>> prs((ls.size() + CHK - 1) / CHK);
+        pfor(prs.size(), [&](size_t c) {
+            Span sp("merge chunk", c);
+            for (size_t i = c * CHK; i < ls.size() && i < (c + 1) * CHK; ++i)
+                for (uint32_t b = ls[i].c & ~ls[i].v; b; b &= b - 1) {
+                    auto it = idx.find(key({ls[i].v | (b & -b), ls[i].c}));
+                    if (it != idx.end())
+                        prs[c].emplace_back(i, it->second);
+                }
+        });
+        std::vector<char> chk(ls.size(), 0);
+        std::unordered_set<uint64_t> vis;
+        for (auto &i : prs)
+            for (auto &p : i) {
+                Cube tmp = {ls[p.first].v, ls[p.first].c & ~(ls[p.first].v ^ ls[p.second].v)};
+                if (vis.insert(key(tmp)).second)
+                    tls.emplace_back(tmp);
+                chk[p.first] = chk[p.second] = 1;
+                f = true;
+            }
+        for (size_t i = 0; i < ls.size(); ++i)
+            if (!chk[i])
+                tls.emplace_back(ls[i]);
+        absorb(tls);
+        ls.swap(tls);
+    } while (f);
+    return ls;
+}
+
+// Generate primes by iterated consensus
+// Every new cube is combined with all kept cubes; a consensus not covered by a kept cube is
+// appended and absorbs the cubes it covers. Starts from the minterms, O(K^2) pairs for K cubes,
+// independent of 2^N, so it suits sparse functions. Kept cubes are grouped by care mask as in
+// absorb(): covering cubes are looked up in the masks that are subsets, covered ones in the
+// supersets, by scanning the group or probing its values, whichever is smaller
+std::vector<Cube> pcons(int n, const std::vector<size_t>& ons, const std::vector<size_t>& dcs) {
+    Phase ph("consensus");
+    std::vector<Cube> ls;
+    uint32_t all = (uint32_t)(((uint64_t)1 << n) - 1);
+    for (auto &i : ons)
+        ls.push_back({(uint32_t)i, all});
+    for (auto &i : dcs)
+        ls.push_back({(uint32_t)i, all});
+    std::sort(ls.begin(), ls.end(), [](const Cube& a, const Cube& b) {
+        return a.v < b.v;
+    });
+    std::vector<char> dead(ls.size(), 0);
+    // Kept cubes, care mask -> value -> index
+    std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>> grp;
+    std::vector<uint32_t> msk;
+    auto add = [&](size_t i) {
+        auto it = grp.find(ls[i].c);
+        if (it == grp.end()) {
+            msk.emplace_back(ls[i].c);
+            it = grp.emplace(ls[i].c, std::unordered_map<uint32_t, uint32_t>()).first;
+        }
+        it->second.emplace(ls[i].v, i);
+    };
+    for (size_t i = 0; i < ls.size(); ++i)
+        add(i);
+    std::vector<uint32_t> rm;
+    for (size_t i = 1; i < ls.size(); ++i)
+        for (size_t j = 0; j < i && !dead[i]; ++j) {
+            if (dead[j])
+                continue;
+            uint32_t d = ls[i].c & ls[j].c & (ls[i].v ^ ls[j].v);
+            if (!d || (d & (d - 1)))
+                continue;
+            Cube x = {0, (ls[i].c | ls[j].c) & ~d};
+            x.v = (ls[i].v | ls[j].v) & x.c;
+            bool cov = false;
+            for (size_t k = 0; k < msk.size() && !cov; ++k)
+                if (!(msk[k] & ~x.c)) {
+                    auto &g = grp[msk[k]];
+                    cov = g.count(x.v & msk[k]);
+                }
+            if (cov)
+                continue;
+            for (auto &m : msk) {
+                if (x.c & ~m)
+                    continue;
+                auto &g = grp[m];
+                uint32_t fr = m & ~x.c;
+                rm.clear();
+                if (__builtin_popcount(fr) >= 32 || g.size() < ((size_t)1 << __builtin_popcount(fr))) {
+                    for (auto &e : g)
+                        if ((e.first & x.c) == x.v)
+                            rm.emplace_back(e.first);
+                }
+                else
+                    for (uint32_t t = 0; ; t = (t - fr) & fr) {
+                        if (g.count(x.v | t))
+                            rm.emplace_back(x.v | t);
+                        if (((t - fr) & fr) == 0)
+                            break;
+                    }
+                for (auto &v : rm) {
+                    dead[g[v]] = 1;
+                    g.erase(v);
+                }
+            }
+            ls.emplace_back(x);
+            dead.emplace_back(0);
+            add(ls.size() - 1);
+        }
+    std::vector<Cube> rtn;
+    for (size_t i = 0; i < ls.size(); ++i)
+        if (!dead[i])
+            rtn.emplace_back(ls[i]);
+    return rtn;
+}
+
+// Spectral features
+// aff: f is the parity of the variables in afm, negated if afc. lin: variables with f(x^xi) = f(x)',
+// ci: correlation immunity order, sym: totally symmetric, prm: estimated number of primes
+struct Spec {
+    bool aff, afc, sym;
+    uint32_t afm, lin;
+    int ci;
+    double prm;
+};
+
+// Walsh-Hadamard spectrum
+// W(a) = sum of (-1)^(f(x)^a.x). The low 6 variables are bit-sliced: W over one word is its size minus
+// twice the popcount of the word XOR the parity pattern of a, the high variables are butterflies
+// over words. O(N*2^N) time, 2^N counters, so only up to 20 variables
+Spec spec(int n, const std::vector<uint64_t>& b) {
+    Phase ph("spectrum");
+    size_t lmt = (size_t)1 << n;
+    uint64_t par[64];
+    for (int a = 0; a < 64; ++a) {
+        par[a] = 0;
+        for (int i = 0; i < 6; ++i)
+            if ((a >> i) & 1)
+                par[a] ^= prj[i];
+    }
+    std::vector<int32_t> W(lmt);
+    size_t L = std::min<size_t>(lmt, 64);
+    uint64_t msk = L == 64 ? ~0ull : (1ull << L) - 1;
+    for (size_t w = 0; w < b.size(); ++w)
+        for (size_t a = 0; a < L; ++a)
+            W[w * 64 + a] = L - 2 * __builtin_popcountll((b[w] ^ par[a]) & msk);
+    for (size_t h = 64; h < lmt; h <<= 1)
+        for (size_t i = 0; i < lmt; i += h << 1)
+            for (size_t j = i; j < i + h; ++j) {
+                int32_t x = W[j], y = W[j + h];
+                W[j] = x + y;
+                W[j + h] = x - y;
+            }
+    Spec rtn = {false, false, true, 0, ~0u, n, 0};
+    std::vector<int64_t> wv(n + 1, INT64_MIN);
+    for (size_t a = 0; a < lmt; ++a) {
+        int k = __builtin_popcount(a);
+        if (wv[k] == INT64_MIN)
+            wv[k] = W[a];
+        rtn.sym = rtn.sym && wv[k] == W[a];
+        if (!W[a])
+            continue;
+        rtn.lin &= a;
+        if (a)
+            rtn.ci = std::min(rtn.ci, k - 1);
+        if ((size_t)std::abs(W[a]) == lmt) {
+            rtn.aff = true;
+            rtn.afm = a;
+            rtn.afc = W[a] < 0;
+        }
+    }
+    rtn.lin &= (uint32_t)(lmt - 1);
+    // Expected implicants of a random function of the density, on the non-linear variables;
+    // every prime fixes all linear variables
+    int l = __builtin_popcount(rtn.lin), m = n - l;
+    double p = (lmt - W[0]) / 2.0 / lmt, cnk = 1;
+    for (int k = 0; k <= m; ++k) {
+        rtn.prm += cnk * std::ldexp(std::pow(p, std::ldexp(1, k)), m - k);
+        cnk = cnk * (m - k) / (k + 1);
+    }
+    rtn.prm = std::ldexp(rtn.prm, l);
+    if (ostats) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "spectrum: affine %s, linear variables %d, correlation immunity %d, symmetric %s, primes ~%.3g",
+                      rtn.aff ? "yes" : "no", l, rtn.ci, rtn.sym ? "yes" : "no", rtn.prm);
+        notes.emplace_back(buf);
+    }
+    return rtn;
+}
+
+// Affine cover
+// The parity of K variables has the 2^(K-1) odd (or even) minterms over them as its only primes
+std::vector<Cube> affine(const Spec& sp) {
+    Phase ph("affine");
+    std::vector<Cube> rtn;
+    for (uint32_t v = sp.afm; ; v = (v - 1) & sp.afm) {
+        if ((__builtin_popcount(v) & 1) != sp.afc)
+            rtn.push_back({v, sp.afm});
+        if (!v)
+            break;
+    }
+    return rtn;
+}
+
+// Symmetric variable pair
+// f with xi = 1, xj = 0 equals f with xi = 0, xj = 1, i < j; compared a word at a time
+bool symp(const std::vector<uint64_t>& b, int i, int j) {
+    if (j < 6) {
+        int d = (1 << j) - (1 << i);
+        uint64_t msk = prj[i] & ~prj[j];
+        for (auto &w : b)
+            if ((w & msk) != ((w >> d) & msk))
+                return false;
+        return true;
+    }
+    size_t J = (size_t)1 << (j - 6);
+    if (i < 6) {
+        int d = 1 << i;
+        for (size_t w = 0; w < b.size(); ++w)
+            if (!(w & J) && (b[w] & prj[i]) != ((b[w | J] & ~prj[i]) << d))
+                return false;
+        return true;
+    }
+    size_t I = (size_t)1 << (i - 6);
+    for (size_t w = 0; w < b.size(); ++w)
+        if ((w & I) && !(w & J) && b[w] != b[w ^ I ^ J])
+            return false;
+    return true;
+}
+
+// Symmetry groups
+// Symmetry of ON and DC is transitive, so each variable is only tested against the first member of
+// every group. O(N*G*2^N/64) for G groups
+std::vector<uint32_t> symm(int n, const std::vector<uint64_t>& onb, const std::vector<uint64_t>& dcb) {
+    Phase ph("symmetry");
+    std::vector<uint32_t> rtn;
+    for (int j = 0; j < n; ++j) {
+        bool f = false;
+        for (auto &g : rtn) {
+            int i = __builtin_ctz(g);
+            if (symp(onb, i, j) && symp(dcb, i, j)) {
+                g |= 1u << j;
+                f = true;
+                break;
+            }
+        }
+        if (!f)
+            rtn.emplace_back(1u << j);
+    }
+    return rtn;
+}
+
+// Prime types of symmetric groups
+// The function only depends on the number of ones w in every group. A cube type takes p positive
+// and q negative literals from each group of size s, all its cubes cover the weight box [p, s-q].
+// Per group, types are indexed p*(s+1)+q; growing p or q grows the mixed radix index, so
+// implicant and ON-touching flags are filled downwards: a box is a point or the union of the two
+// boxes one step narrower in some group. Prime types are instantiated into every cube, so only
+// prime generation gets faster, the covering table is as large as with merging
+std::vector<Cube> psym(const std::vector<uint64_t>& onb, const std::vector<uint64_t>& dcb, const std::vector<uint32_t>& grp) {
+    Phase ph("symmetry primes");
+    size_t G = grp.size(), T = 1;
+    std::vector<int> sz(G);
+    std::vector<size_t> rad(G);
+    for (size_t g = 0; g < G; ++g) {
+        sz[g] = __builtin_popcount(grp[g]);
+        rad[g] = T;
+        T *= (sz[g] + 1) * (sz[g] + 1);
+    }
+    auto pq = [&](size_t t, size_t g, int& p, int& q) {
+        p = t / rad[g] % ((sz[g] + 1) * (sz[g] + 1)) / (sz[g] + 1);
+        q = t / rad[g] % (sz[g] + 1);
+    };
+    // 0 not implicant, 1 implicant, 2 implicant touching ON
+    std::vector<char> imp(T, 0);
+    for (size_t t = T; t--; ) {
+        int g0 = -1;
+        uint32_t pt = 0;
+        bool ok = true;
+        for (size_t g = 0; g < G && ok; ++g) {
+            int s = sz[g], p, q;
+            pq(t, g, p, q);
+            if (p + q > s)
+                ok = false;
+            else if (p + q < s && g0 < 0)
+                g0 = g;
+            // Representative point: the lowest p members of the group are ones
+            uint32_t m = grp[g];
+            for (int k = 0; k < p; ++k, m &= m - 1)
+                pt |= m & -m;
+        }
+        if (!ok)
+            continue;
+        if (g0 < 0) {
+            imp[t] = bit(onb, pt) ? 2 : bit(dcb, pt) ? 1 : 0;
+            continue;
+        }
+        int s = sz[g0];
+        char a = imp[t + (s + 1) * rad[g0]], b = imp[t + rad[g0]];
+        imp[t] = a && b ? std::max(a, b) : 0;
+    }
+    std::vector<Cube> rtn;
+    std::vector<std::pair<uint32_t, uint32_t>> cur, tmp;
+    for (size_t t = 0; t < T; ++t) {
+        if (imp[t] != 2)
+            continue;
+        bool prm = true;
+        for (size_t g = 0; g < G && prm; ++g) {
+            int s = sz[g], p, q;
+            pq(t, g, p, q);
+            prm = (!p || !imp[t - (s + 1) * rad[g]]) && (!q || !imp[t - rad[g]]);
+        }
+        if (!prm)
+            continue;
+        // Instantiate: every choice of p positive and q negative members per group
+        cur.assign(1, {0, 0});
+        for (size_t g = 0; g < G; ++g) {
+            int p, q;
+            pq(t, g, p, q);
+            tmp.clear();
+            for (uint32_t P = grp[g]; ; P = (P - 1) & grp[g]) {
+                if (__builtin_popcount(P) == p)
+                    for (uint32_t Q = grp[g] & ~P; ; Q = (Q - 1) & grp[g] & ~P) {
+                        if (__builtin_popcount(Q) == q)
+                            for (auto &c : cur)
+                                tmp.push_back({c.first | P, c.second | P | Q});
+                        if (!Q)
+                            break;
+                    }
+                if (!P)
+                    break;
+            }
+            cur.swap(tmp);
+        }
+        for (auto &c : cur)
+            rtn.push_back({c.first, c.second});
+    }
+    return rtn;
+}
+
+// Symmetric prime generation test
+// Worth it if some group has two variables; the type table must stay small either way
+bool symmetric(const std::vector<uint32_t>& grp, bool frc) {
+    size_t T = 1;
+    bool f = false;
+    for (auto &g : grp) {
+        size_t s = __builtin_popcount(g);
+        T *= (s + 1) * (s + 1);
+        f = f || s > 1;
+        if (T > ((size_t)1 << 22))
+            return false;
+    }
+    return f || frc;
+}
+
+// Sparse function test
+// Consensus pairs the kept cubes, so it only pays off while the function has few implicants;
+// density alone misses ON sets clustered in a subcube. Implicants are estimated from the
+// share p of ON and DC neighbours of the K minterms: a cube of 2^j minterms through a minterm
+// needs the other 2^j - 1 to be set, about K*C(N,j)*p^(2^j-1)/2^j cubes per level. O(K*N)
+bool sparse(int n, const std::vector<size_t>& ons, const std::vector<size_t>& dcs,
+            const std::vector<uint64_t>& onb, const std::vector<uint64_t>& dcb) {
+    size_t k = ons.size() + dcs.size(), adj = 0;
+    if (k > 1024)
+        return false;
+    for (auto l : {&ons, &dcs})
+        for (auto &x : *l)
+            for (int i = 0; i < n; ++i)
+                adj += bit(onb, x ^ ((size_t)1 << i)) || bit(dcb, x ^ ((size_t)1 << i));
+    double p = k ? (double)adj / k / n : 0, est = 0, cnk = 1;
+    for (int j = 0; j <= n && est <= 1024; ++j) {
+        est += k * cnk * std::pow(p, std::ldexp(1, j) - 1) / std::ldexp(1, j);
+        cnk = cnk * (n - j) / (j + 1);
+    }
+    return est <= 1024;
+}
+
+// Unate test
+// Variable i is positive unate if no ON minterm turns OFF when i goes from 0 to 1, negative if the
+// reverse; neg gets the negative ones. O(N*2^N/64)
+bool unate(int n, const std::vector<uint64_t>& b, uint32_t& neg) {
+    neg = 0;
+    for (int i = 0; i < n; ++i) {
+        uint64_t up = 0, dn = 0;
+        if (i < 6) {
+            int s = 1 << i;
+            for (auto &w : b) {
+                up |= ((w & ~prj[i]) << s) & ~w;
+                dn |= ((w & prj[i]) >> s) & ~w;
+            }
+        }
+        else
+            for (size_t w = 0, W = (size_t)1 << (i - 6); w < b.size(); ++w)
+                if (!(w & W)) {
+                    up |= b[w] & ~b[w | W];
+                    dn |= b[w | W] & ~b[w];
+                }
+        if (up && dn)
+            return false;
+        if (up)
+            neg |= 1u << i;
+    }
+    return true;
+}
+
+// Minimal true points
+// With the negative variables flipped the function is monotone: its primes are the true points
+// whose every single-variable lowering is false, and all of them are essential. O(N*2^N/64)
+std::vector<Cube> mtp(int n, const std::vector<uint64_t>& b, uint32_t neg) {
+    Phase ph("unate");
+    std::vector<uint64_t> bad(b.size(), 0);
+    for (int i = 0; i < n; ++i) {
+        bool ng = (neg >> i) & 1;
+        if (i < 6) {
+            int s = 1 << i;
+            for (size_t w = 0; w < b.size(); ++w)
+                bad[w] |= ng ? b[w] & ~prj[i] & (b[w] >> s) : b[w] & prj[i] & (b[w] << s);
+        }
+        else
+            for (size_t w = 0, W = (size_t)1 << (i - 6); w < b.size(); ++w)
+                if (!(w & W) == ng)
+                    bad[w] |= b[w] & b[w ^ W];
+    }
+    std::vector<Cube> rtn;
+    uint32_t all = (uint32_t)(((uint64_t)1 << n) - 1);
+    for (size_t w = 0; w < b.size(); ++w)
+        for (uint64_t x = b[w] & ~bad[w]; x; x &= x - 1) {
+            uint32_t j = w * 64 + __builtin_ctzll(x);
+            uint32_t c = (j ^ neg) & all;
+            rtn.push_back({j & c, c});
+        }
+    return rtn;
+}
+
+// Expand minterms into primes
+// Take the first uncovered ON minterm and drop literals while the cube stays inside ON and DC,
+// each time the literal whose other half covers most uncovered minterms. Redundant cubes are
+// dropped afterwards, latest first. O(K*N^2) bitmap intersections for a cover of K cubes
+std::vector<Cube> expand(int n, const std::vector<uint64_t>& onb, const std::vector<uint64_t>& cb) {
+    Phase ph("expand");
+    std::vector<Cube> rtn;
+    std::vector<uint64_t> unc(onb);
+    uint32_t all = (uint32_t)(((uint64_t)1 << n) - 1);
+    for (size_t w = 0; w < unc.size(); ) {
+        if (!unc[w]) {
+            ++w;
+            continue;
+        }
+        Cube x = {(uint32_t)(w * 64 + __builtin_ctzll(unc[w])), all};
+        for (;;) {
+            int bst = -1;
+            size_t bg = 0, sz = (size_t)1 << (n - __builtin_popcount(x.c));
+            for (uint32_t c = x.c; c; c &= c - 1) {
+                Cube h = {x.v ^ (c & -c), x.c};
+                if (ccount(h, n, cb) != sz)
+                    continue;
+                size_t g = ccount(h, n, unc);
+                if (bst < 0 || g > bg) {
+                    bst = __builtin_ctz(c);
+                    bg = g;
+                }
+            }
+            if (bst < 0)
+                break;
+            x.c &= ~(1u << bst);
+            x.v &= x.c;
+        }
+        rtn.emplace_back(x);
+        cclear(x, n, unc);
+    }
+    // Minterms covered once and more than once by the kept cubes
+    std::vector<uint64_t> c1, c2;
+    auto cnt = [&]() {
+        c1.assign(onb.size(), 0);
+        c2.assign(onb.size(), 0);
+        for (auto &x : rtn)
+            forWords(x, n, [&](size_t w, uint64_t p) {
+                c2[w] |= c1[w] & p;
+                c1[w] |= p;
+            });
+    };
+    cnt();
+    for (size_t i = rtn.size(); i--; ) {
+        bool red = true;
+        forWords(rtn[i], n, [&](size_t w, uint64_t p) {
+            red = red && !(onb[w] & p & ~c2[w]);
+        });
+        if (red) {
+            rtn.erase(rtn.begin() + i);
+            cnt();
+        }
+    }
+    return rtn;
+}
+
+// Independent minterm bound
+// Two ON minterms are independent if their supercube holds an OFF minterm, then no implicant covers
+// both. Minterms independent of all kept ones are kept greedily, every kept one needs its own
+// term. A supercube is searched for an OFF minterm in at most 16 words, pairs left unresolved
+// and minterms past a total of 2^24 pair checks are skipped, which only weakens the bound
+size_t indep(int n, const std::vector<uint64_t>& onb, const std::vector<uint64_t>& cb) {
+    Phase ph("bound");
+    std::vector<uint32_t> ks;
+    uint32_t all = (uint32_t)(((uint64_t)1 << n) - 1);
+    size_t wrk = 0;
+    auto off = [&](uint32_t x, uint32_t y) {
+        Cube h = {x & ~(x ^ y) & all, ~(x ^ y) & all};
+        uint64_t pat = lpat(h);
+        if (n <= 6)
+            return (pat & ~cb[0] & (n == 6 ? ~0ull : (1ull << (1 << n)) - 1)) != 0;
+        uint32_t hv = h.v >> 6, fh = ~(h.c >> 6) & ((1u << (n - 6)) - 1);
+        int k = 0;
+        for (uint32_t s = 0; k < 16; s = (s - fh) & fh, ++k) {
+            if (pat & ~cb[hv | s])
+                return true;
+            if (((s - fh) & fh) == 0)
+                break;
+        }
+        return false;
+    };
+    for (size_t w = 0; w < onb.size() && wrk < ((size_t)1 << 24); ++w)
+        for (uint64_t b = onb[w]; b && wrk < ((size_t)1 << 24); b &= b - 1) {
+            uint32_t x = w * 64 + __builtin_ctzll(b);
+            bool ok = true;
+            for (size_t i = ks.size(); ok && i--; ) {
+                ++wrk;
+                ok = off(x, ks[i]);
+            }
+            if (ok)
+                ks.emplace_back(x);
+        }
+    return ks.size();
+}
+
+// Connected components of covering matrix
+// Columns sharing a row are joined, each component is an independent covering problem
+std::vector<Mat> split(const Mat& a) {
+    size_t C = a.col.size();
+    std::vector<uint32_t> par(C);
+    for (size_t i = 0; i < C; ++i)
+        par[i] = i;
+    std::function<uint32_t(uint32_t)> fnd = [&](uint32_t x) {
+        while (par[x] != x)
+            x = par[x] = par[par[x]];
+        return x;
+    };
+    for (auto &r : a.rc)
+        for (size_t k = 1; k < r.size(); ++k)
+            par[fnd(r[k])] = fnd(r[0]);
+    // Number components by their first column
+    std::vector<int> cid(C, -1);
+    std::vector<Mat> rtn;
+    std::vector<uint32_t> lc(C);
+    for (size_t c = 0; c < C; ++c) {
+        uint32_t p = fnd(c);
+        if (cid[p] < 0) {
+            cid[p] = rtn.size();
+            rtn.emplace_back();
+        }
+        Mat &m = rtn[cid[p]];
+        lc[c] = m.col.size();
+        m.col.emplace_back(a.col[c]);
+        m.cst.emplace_back(a.cst[c]);
+        m.cr.emplace_back();
+    }
+    for (auto &r : a.rc) {
+        Mat &m = rtn[cid[fnd(r[0])]];
+        uint32_t id = m.rc.size();
+        m.rc.emplace_back();
+        for (auto &c : r) {
+            m.rc.back().emplace_back(lc[c]);
+            m.cr[lc[c]].emplace_back(id);
+        }
+    }
+    return rtn;
+}
+
+// Cover
+// Matrix methods run on the cyclic core left after essential columns and dominance, split into
+// connected components that are solved in parallel. auto solves small components exactly and
+// large ones by the Lagrangian heuristic. exact and sat keep their best cover when they hit
+// their search limit.
+// The lower bound is essential columns plus, per component, the size of a proven minimum cover
+// or its Lagrangian bound. opt is set if exact proved every component minimum by terms then literals
+std::vector<Cube> cover(int n, const std::vector<Cube>& prm, const std::vector<uint64_t>& onb, bool& opt) {
+    std::vector<Cube> rtn;
+    opt = false;
+    if (ocover == "gpl" || ocover == "chvatal") {
+        rtn = ocover == "gpl" ? gpl(n, prm, onb) : chv(n, prm, onb);
+        if (obound) {
+            Phase ph("bound");
+            std::vector<Cube> ess;
+            std::vector<uint32_t> tmp;
+            Mat core = reduce(mkMat(n, prm, onb), ess);
+            blb += ess.size();
+            for (auto &i : split(core))
+                blb += lagr(i, tmp);
+        }
+        return rtn;
+    }
+    Phase ph("cover");
+    Mat core = reduce(mkMat(n, prm, onb), rtn);
+    if (obound)
+        blb += rtn.size();
+    auto cps = split(core);
+    std::vector<std::vector<uint32_t>> sel(cps.size());
+    std::vector<double> lbs(cps.size(), 0);
+    std::atomic<bool> lmt(false);
+    std::atomic<size_t> nlm(0), nex(0);
+    int tc = cps.size() > 1 ? 1 : othreads;
+    pfor(cps.size(), [&](size_t i) {
+        Span sp("component", i);
+        auto &a = cps[i];
+        if (ocover == "lagr" || (ocover == "auto" && (a.col.size() > 48 || a.rc.size() > 512)))
+            lbs[i] = lagr(a, sel[i]);
+        else if (ocover == "sat") {
+            if (satCover(a, sel[i], 200000))
+                lbs[i] = sel[i].size();
+            else {
+                // Not proven minimum, only the Lagrangian bound holds
+                std::vector<uint32_t> tmp;
+                lmt = true;
+                ++nlm;
+                lbs[i] = lagr(a, tmp);
+            }
+        }
+        else if (exact(a, sel[i], tc, 1000000)) {
+            lbs[i] = sel[i].size();
+            ++nex;
+        }
+        else {
+            // Keep the better of the incumbent and the Lagrangian cover, proven if it meets the bound
+            std::vector<uint32_t> tmp;
+            lbs[i] = lagr(a, tmp);
+            if (tmp.size() < sel[i].size())
+                sel[i].swap(tmp);
+            if (sel[i].size() > lbs[i])
+                ++nlm;
+        }
+    });
+    if (lmt)
+        std::cerr << "[WARN] SAT conflict limit reached, cover may not be minimum" << std::endl;
+    else if (nlm)
+        std::cerr << "[WARN] Exact node limit reached, cover may not be minimum" << std::endl;
+    if (nlm && ostats)
+        notes.emplace_back("cover: search limit reached in " + std::to_string(nlm.load()) + " of " +
+                               std::to_string(cps.size()) + " components, cover not proven optimal");
+    opt = nex == cps.size();
+    for (size_t i = 0; i < cps.size(); ++i) {
+        if (obound)
+            blb += lbs[i];
+        for (auto &j : sel[i])
+            rtn.emplace_back(cps[i].col[j]);
+    }
+    return rtn;
+}
+
+// Single-word engine
+// For N <= 6 the truth table is one word. Bit x of imp[F] is set if the cube through x with free
+// variables F lies inside ON and DC, one swap per set. Primes are implicants that touch ON and that
+// no further free variable extends. They are covered exactly by branch and bound over fixed arrays,
+// terms then literals, with an independent row bound. The word phase performs no heap allocation,
+// the callers around it (tvt, QMA, output) do
+size_t wcover(int n, uint64_t onw, uint64_t dcw, Cube *out) {
+    Phase ph("word", -1, true);
+    uint32_t vs = (1u << n) - 1;
+    uint64_t all = n == 6 ? ~0ull : (1ull << (1 << n)) - 1;
+    auto swp = [](uint64_t w, int i) {
+        int s = 1 << i;
+        return ((w & prj[i]) >> s) | ((w & ~prj[i]) << s);
+    };
+    uint64_t imp[64], any[64];
+    imp[0] = (onw | dcw) & all;
+    any[0] = onw & all;
+    for (uint32_t F = 1; F <= vs; ++F) {
+        int i = __builtin_ctz(F);
+        imp[F] = imp[F & (F - 1)] & swp(imp[F & (F - 1)], i);
+        any[F] = any[F & (F - 1)] | swp(any[F & (F - 1)], i);
+    }
+    // Primes, one representative point per cube
+    Cube prm[729];
+    uint64_t pat[729];
+    int np = 0;
+    for (uint32_t F = 0; F <= vs; ++F) {
+        uint64_t ext = 0, rep = all;
+        for (int i = 0; i < n; ++i)
+            if ((F >> i) & 1)
+                rep &= ~prj[i];
+            else
+                ext |= imp[F | 1u << i];
+        for (uint64_t x = imp[F] & ~ext & any[F] & rep; x; x &= x - 1) {
+            prm[np] = {(uint32_t)__builtin_ctzll(x), vs & ~F};
+            pat[np] = lpat(prm[np]) & all;
+            ++np;
+        }
+    }
+    // Larger cubes first, for early incumbents
+    int ord[729];
+    for (int k = 0; k < np; ++k)
+        ord[k] = k;
+    std::sort(ord, ord + np, [&](int a, int b) {
+        return __builtin_popcount(prm[a].c) < __builtin_popcount(prm[b].c);
+    });
+    // Per ON minterm: union of its primes, their number and least cost
+    uint64_t cov[64] = {0}, mc[64];
+    int cnt[64] = {0};
+    std::fill(mc, mc + 64, ~0ull);
+    for (int k = 0; k < np; ++k)
+        for (uint64_t x = pat[k] & onw; x; x &= x - 1) {
+            int j = __builtin_ctzll(x);
+            cov[j] |= pat[k];
+            ++cnt[j];
+            mc[j] = std::min(mc[j], cost(prm[k]));
+        }
+    // Primes already tried at a shallower branch are banned below it
+    int sel[64], bsel[64], nb = 0;
+    uint64_t best = ~0ull;
+    auto rec = [&](auto& self, uint64_t unc, uint64_t cst, int d, const uint64_t *ban) -> void {
+        if (!unc) {
+            if (cst < best) {
+                best = cst;
+                nb = d;
+                std::copy(sel, sel + d, bsel);
+            }
+            return;
+        }
+        uint64_t lb = 0, avl = 0;
+        for (uint64_t r = unc; r; r &= ~cov[__builtin_ctzll(r)])
+            lb += mc[__builtin_ctzll(r)];
+        if (cst + lb >= best)
+            return;
+        for (int k = 0; k < np; ++k)
+            if (!((ban[k >> 6] >> (k & 63)) & 1))
+                avl |= pat[k];
+        if (unc & ~avl)
+            return;
+        int j = -1;
+        for (uint64_t r = unc; r; r &= r - 1)
+            if (j < 0 || cnt[__builtin_ctzll(r)] < cnt[j])
+                j = __builtin_ctzll(r);
+        uint64_t nbn[12];
+        std::copy(ban, ban + 12, nbn);
+        for (int i = 0; i < np; ++i) {
+            int k = ord[i];
+            if (((pat[k] >> j) & 1) && !((nbn[k >> 6] >> (k & 63)) & 1)) {
+                sel[d] = k;
+                self(self, unc & ~pat[k], cst + cost(prm[k]), d + 1, nbn);
+                nbn[k >> 6] |= 1ull << (k & 63);
+            }
+        }
+    };
+    uint64_t ban[12] = {0};
+    rec(rec, onw & all, 0, 0, ban);
+    for (int k = 0; k < nb; ++k)
+        out[k] = prm[bsel[k]];
+    return nb;
+}
+
+// NPN canonical form
+// Smallest truth table over the 768 input permutations, input and output negations.
+// Bit y of a candidate is t at P(y)^m, negated if o, where P moves bit j of y to bit p[j]
+uint16_t npnC(uint16_t t, int *p, int& m, int& o) {
+    uint16_t rtn = 0xffff;
+    int q[4] = {0, 1, 2, 3}, py[16];
+    do {
+        for (int y = 0; y < 16; ++y) {
+            py[y] = 0;
+            for (int j = 0; j < 4; ++j)
+                py[y] |= ((y >> j) & 1) << q[j];
+        }
+        for (int i = 0; i < 16; ++i) {
+            uint16_t tmp = 0;
+            for (int y = 0; y < 16; ++y)
+                tmp |= ((t >> (py[y] ^ i)) & 1) << y;
+            for (int k = 0; k < 2; ++k, tmp = ~tmp)
+                if (tmp <= rtn) {
+                    rtn = tmp;
+                    std::copy(q, q + 4, p);
+                    m = i;
+                    o = k;
+                }
+        }
+    } while (std::next_permutation(q, q + 4));
+    return rtn;
+}
+
+// NPN class database
+// Minimum covers (terms, then literals) of every 4-variable NPN class, generated by "qma gen npn".
+// Per class, in truth table order: canonical table (2 bytes, little endian), then the cube count and
+// cubes of the class function and of its complement, a cube is c << 4 | v
+const uint8_t npndb[] = {
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0xf0, 0x04, 0x11, 0x22, 0x44, 0x88, 0x03, 0x00,
+    0x01, 0xe0, 0x03, 0x22, 0x44, 0x88, 0x06, 0x00, 0x02, 0xf1, 0xf2, 0x04, 0x30, 0x33, 0x44, 0x88,
+    0x07, 0x00, 0x02, 0xe0, 0xd0, 0x03, 0x33, 0x44, 0x88, 0x0f, 0x00, 0x01, 0xc0, 0x02, 0x44, 0x88,
+    0x16, 0x00, 0x03, 0xf1, 0xf2, 0xf4, 0x05, 0x70, 0x33, 0x55, 0x66, 0x88, 0x17, 0x00, 0x03, 0xe0,
+    0xd0, 0xb0, 0x04, 0x33, 0x55, 0x66, 0x88, 0x18, 0x00, 0x02, 0xf3, 0xf4, 0x04, 0x88, 0x60, 0x32,
+    0x55, 0x19, 0x00, 0x02, 0xb0, 0xf3, 0x04, 0x31, 0x32, 0x88, 0x55, 0x1b, 0x00, 0x02, 0xd1, 0xb0,
+    0x03, 0x32, 0x55, 0x88, 0x1e, 0x00, 0x03, 0xd1, 0xe2, 0xf4, 0x04, 0x70, 0x55, 0x66, 0x88, 0x1f,
+    0x00, 0x02, 0xc0, 0xb0, 0x03, 0x55, 0x66, 0x88, 0x3c, 0x00, 0x02, 0xe2, 0xe4, 0x03, 0x60, 0x66,
+    0x88, 0x3d, 0x00, 0x03, 0xe2, 0xe4, 0xd0, 0x03, 0x71, 0x66, 0x88, 0x3f, 0x00, 0x02, 0xc0, 0xa0,
+    0x02, 0x66, 0x88, 0x69, 0x00, 0x04, 0xf0, 0xf3, 0xf5, 0xf6, 0x05, 0x71, 0x72, 0x74, 0x77, 0x88,
+    0x6b, 0x00, 0x04, 0xe0, 0xd1, 0xb1, 0xf6, 0x04, 0x72, 0x74, 0x77, 0x88, 0x6f, 0x00, 0x03, 0xc0,
+    0xb1, 0xb2, 0x03, 0x74, 0x77, 0x88, 0x7e, 0x00, 0x03, 0xd1, 0xb2, 0xe4, 0x03, 0x70, 0x77, 0x88,
+    0x7f, 0x00, 0x03, 0xc0, 0xa0, 0x90, 0x02, 0x77, 0x88, 0xff, 0x00, 0x01, 0x80, 0x01, 0x88, 0x16,
+    0x01, 0x04, 0xf1, 0xf2, 0xf4, 0xf8, 0x07, 0xf0, 0x33, 0x55, 0x66, 0x99, 0xaa, 0xcc, 0x17, 0x01,
+    0x04, 0xe0, 0xd0, 0xb0, 0x70, 0x06, 0x33, 0x55, 0x66, 0x99, 0xaa, 0xcc, 0x18, 0x01, 0x03, 0xf3,
+    0xf4, 0xf8, 0x05, 0xcc, 0xe0, 0x32, 0x55, 0x99, 0x19, 0x01, 0x03, 0xf3, 0xb0, 0x70, 0x05, 0x31,
+    0x32, 0xcc, 0x55, 0x99, 0x1a, 0x01, 0x03, 0xd1, 0xf4, 0xf8, 0x05, 0xd0, 0x55, 0x99, 0xcc, 0x32,
+    0x1b, 0x01, 0x03, 0xd1, 0xb0, 0x70, 0x04, 0x32, 0x55, 0x99, 0xcc, 0x1e, 0x01, 0x04, 0xd1, 0xe2,
+    0xf4, 0xf8, 0x06, 0xf0, 0x55, 0x66, 0x99, 0xaa, 0xcc, 0x1f, 0x01, 0x03, 0xc0, 0xb0, 0x70, 0x05,
+    0x55, 0x66, 0x99, 0xaa, 0xcc, 0x2c, 0x01, 0x03, 0xe2, 0xf5, 0xf8, 0x05, 0x66, 0xaa, 0xe0, 0x54,
+    0x99, 0x2d, 0x01, 0x03, 0xe2, 0xf5, 0x70, 0x05, 0x71, 0x54, 0x66, 0xaa, 0x99, 0x2f, 0x01, 0x03,
+    0xc0, 0xb1, 0x70, 0x04, 0x54, 0x66, 0x99, 0xaa, 0x3c, 0x01, 0x03, 0xe2, 0xe4, 0xf8, 0x05, 0xe0,
+    0x66, 0xaa, 0xcc, 0x99, 0x3d, 0x01, 0x03, 0xe2, 0xe4, 0x70, 0x04, 0x71, 0x66, 0xaa, 0xcc, 0x3e,
+    0x01, 0x04, 0xe2, 0xe4, 0xf8, 0xd1, 0x05, 0xf0, 0x66, 0x99, 0xaa, 0xcc, 0x3f, 0x01, 0x03, 0xc0,
+    0xa0, 0x70, 0x04, 0x66, 0x99, 0xaa, 0xcc, 0x68, 0x01, 0x04, 0xf3, 0xf5, 0xf6, 0xf8, 0x06, 0x77,
+    0xe0, 0xd0, 0x74, 0x99, 0xaa, 0x69, 0x01, 0x04, 0x70, 0xf3, 0xf5, 0xf6, 0x06, 0x71, 0x72, 0x74,
+    0x77, 0x99, 0xaa, 0x6a, 0x01, 0x04, 0xd1, 0xb1, 0xf6, 0xf8, 0x05, 0x77, 0x99, 0xd0, 0x74, 0xaa,
+    0x6b, 0x01, 0x04, 0xd1, 0xb1, 0xf6, 0x70, 0x05, 0x72, 0x74, 0x77, 0x99, 0xaa, 0x6e, 0x01, 0x04,
+    0xb1, 0xb2, 0xf8, 0xd1, 0x05, 0xb0, 0x77, 0x99, 0xaa, 0xcc, 0x6f, 0x01, 0x04, 0xc0, 0xb1, 0xb2,
+    0x70, 0x04, 0x74, 0x77, 0x99, 0xaa, 0x7e, 0x01, 0x04, 0xf8, 0xd1, 0xb2, 0xe4, 0x05, 0xf0, 0x77,
+    0x99, 0xaa, 0xcc, 0x7f, 0x01, 0x04, 0xc0, 0xa0, 0x90, 0x70, 0x04, 0x77, 0x99, 0xaa, 0xcc, 0x80,
+    0x01, 0x02, 0xf7, 0xf8, 0x04, 0xc0, 0x31, 0x54, 0xaa, 0x81, 0x01, 0x02, 0x70, 0xf7, 0x04, 0x99,
+    0x51, 0x32, 0x64, 0x82, 0x01, 0x03, 0xf1, 0xf7, 0xf8, 0x05, 0x90, 0x62, 0x64, 0x99, 0x32, 0x83,
+    0x01, 0x03, 0xe0, 0xf7, 0x70, 0x04, 0x62, 0x64, 0x99, 0x32, 0x86, 0x01, 0x04, 0xf1, 0xf2, 0xf7,
+    0xf8, 0x06, 0xb0, 0x73, 0x64, 0x54, 0x99, 0xaa, 0x87, 0x01, 0x04, 0xe0, 0xd0, 0xf7, 0x70, 0x05,
+    0x73, 0x64, 0x54, 0x99, 0xaa, 0x89, 0x01, 0x02, 0x70, 0xb3, 0x04, 0x31, 0x32, 0x64, 0x99, 0x8b,
+    0x01, 0x03, 0xb3, 0x70, 0xe0, 0x03, 0x32, 0x64, 0x99, 0x8f, 0x01, 0x03, 0xc0, 0xb3, 0x70, 0x04,
+    0x64, 0x54, 0x99, 0xaa, 0x96, 0x01, 0x05, 0xf1, 0xf2, 0xf4, 0xf7, 0xf8, 0x07, 0xf0, 0x73, 0x75,
+    0x76, 0x99, 0xaa, 0xcc, 0x97, 0x01, 0x05, 0xe0, 0xd0, 0xb0, 0xf7, 0x70, 0x06, 0x73, 0x75, 0x76,
+    0x99, 0xaa, 0xcc, 0x98, 0x01, 0x03, 0xb3, 0xf4, 0xf8, 0x05, 0x31, 0x32, 0xcc, 0xe0, 0x99, 0x99,
+    0x01, 0x03, 0xb3, 0xb0, 0x70, 0x04, 0x31, 0x32, 0xcc, 0x99, 0x9a, 0x01, 0x04, 0xd1, 0xf4, 0xb3,
+    0xf8, 0x05, 0xd0, 0x75, 0x32, 0x99, 0xcc, 0x9b, 0x01, 0x04, 0xb0, 0xb3, 0x70, 0xe0, 0x04, 0x32,
+    0x75, 0x99, 0xcc, 0x9e, 0x01, 0x05, 0xd1, 0xe2, 0xf4, 0xb3, 0xf8, 0x06, 0xf0, 0x75, 0x76, 0x99,
+    0xaa, 0xcc, 0x9f, 0x01, 0x04, 0xc0, 0xb0, 0xb3, 0x70, 0x05, 0x75, 0x76, 0x99, 0xaa, 0xcc, 0xa8,
+    0x01, 0x03, 0xb3, 0xd5, 0xf8, 0x04, 0x90, 0x71, 0xaa, 0xcc, 0xa9, 0x01, 0x03, 0x70, 0xb3, 0xd5,
+    0x04, 0x71, 0x32, 0x54, 0x99, 0xaa, 0x01, 0x02, 0x91, 0xf8, 0x04, 0x90, 0x99, 0x32, 0x54, 0xab,
+    0x01, 0x02, 0x91, 0x70, 0x03, 0x32, 0x54, 0x99, 0xac, 0x01, 0x03, 0xe2, 0xd5, 0xf8, 0x04, 0x54,
+    0xaa, 0xe0, 0x99, 0xad, 0x01, 0x03, 0xd5, 0x70, 0xe2, 0x04, 0x71, 0x54, 0xaa, 0x99, 0xae, 0x01,
+    0x03, 0x91, 0xe2, 0xf8, 0x04, 0xb0, 0x54, 0x99, 0xaa, 0xaf, 0x01, 0x03, 0xc0, 0x91, 0x70, 0x03,
+    0x54, 0x99, 0xaa, 0xbc, 0x01, 0x04, 0xe2, 0xe4, 0xf8, 0xb3, 0x05, 0xe0, 0x76, 0xaa, 0xcc, 0x99,
+    0xbd, 0x01, 0x04, 0x70, 0xe2, 0xe4, 0xb3, 0x04, 0x71, 0x76, 0xaa, 0xcc, 0xbe, 0x01, 0x04, 0x91,
+    0xe2, 0xe4, 0xf8, 0x05, 0xf0, 0x76, 0x99, 0xaa, 0xcc, 0xbf, 0x01, 0x04, 0xc0, 0xa0, 0x91, 0x70,
+    0x04, 0x76, 0x99, 0xaa, 0xcc, 0xe8, 0x01, 0x04, 0xb3, 0xd5, 0xe6, 0xf8, 0x05, 0xe0, 0xd0, 0x74,
+    0x99, 0xaa, 0xe9, 0x01, 0x04, 0x70, 0xb3, 0xd5, 0xe6, 0x05, 0x71, 0x72, 0x74, 0x99, 0xaa, 0xea,
+    0x01, 0x03, 0x91, 0xe6, 0xf8, 0x04, 0x99, 0xd0, 0x74, 0xaa, 0xeb, 0x01, 0x03, 0x91, 0xe6, 0x70,
+    0x04, 0x72, 0x74, 0x99, 0xaa, 0xee, 0x01, 0x03, 0x91, 0xa2, 0xf8, 0x04, 0xb0, 0x99, 0xaa, 0xcc,
+    0xef, 0x01, 0x03, 0x91, 0xa2, 0x70, 0x03, 0x74, 0x99, 0xaa, 0xfe, 0x01, 0x04, 0x91, 0xa2, 0xc4,
+    0xf8, 0x04, 0xf0, 0x99, 0xaa, 0xcc, 0x3c, 0x03, 0x03, 0xe2, 0xe4, 0xe8, 0x04, 0xe0, 0x66, 0xaa,
+    0xcc, 0x3d, 0x03, 0x04, 0xe2, 0xe4, 0xe8, 0xd0, 0x04, 0xf1, 0x66, 0xaa, 0xcc, 0x3f, 0x03, 0x03,
+    0xc0, 0xa0, 0x60, 0x03, 0x66, 0xaa, 0xcc, 0x56, 0x03, 0x04, 0x71, 0xb2, 0xd4, 0xe8, 0x05, 0xf0,
+    0x33, 0x55, 0xaa, 0xcc, 0x57, 0x03, 0x02, 0x60, 0x90, 0x04, 0x33, 0x55, 0xaa, 0xcc, 0x58, 0x03,
+    0x03, 0xf3, 0xd4, 0xe8, 0x05, 0x55, 0xaa, 0xcc, 0xe0, 0xd0, 0x59, 0x03, 0x04, 0xf3, 0xd4, 0xe8,
+    0xb0, 0x05, 0xb1, 0x72, 0x55, 0xaa, 0xcc, 0x5a, 0x03, 0x03, 0xd1, 0xd4, 0xe8, 0x04, 0xd0, 0x55,
+    0xaa, 0xcc, 0x5b, 0x03, 0x03, 0xd1, 0xd4, 0x60, 0x04, 0x72, 0x55, 0xaa, 0xcc, 0x5e, 0x03, 0x04,
+    0xd4, 0xe8, 0xd1, 0xe2, 0x04, 0xf0, 0x55, 0xaa, 0xcc, 0x5f, 0x03, 0x03, 0xc0, 0x90, 0x60, 0x03,
+    0x55, 0xaa, 0xcc, 0x68, 0x03, 0x04, 0xf3, 0xf5, 0xf6, 0xe8, 0x06, 0xe0, 0x77, 0xaa, 0xcc, 0xd0,
+    0xb0, 0x69, 0x03, 0x05, 0x70, 0xf3, 0xf5, 0xf6, 0xe8, 0x06, 0xf1, 0x72, 0x74, 0x77, 0xaa, 0xcc,
+    0x6a, 0x03, 0x04, 0xd1, 0xb1, 0xf6, 0xe8, 0x05, 0x77, 0xaa, 0xcc, 0xd0, 0xb0, 0x6b, 0x03, 0x04,
+    0x60, 0xd1, 0xb1, 0xf6, 0x05, 0x72, 0x74, 0x77, 0xaa, 0xcc, 0x6c, 0x03, 0x04, 0xe2, 0xf5, 0xb2,
+    0xe8, 0x05, 0xe0, 0x77, 0xaa, 0xcc, 0xb0, 0x6d, 0x03, 0x05, 0xe2, 0xf5, 0xb2, 0xe8, 0xd0, 0x05,
+    0xf1, 0x74, 0x77, 0xaa, 0xcc, 0x6e, 0x03, 0x04, 0xb1, 0xb2, 0xe8, 0xd1, 0x04, 0xb0, 0x77, 0xaa,
+    0xcc, 0x6f, 0x03, 0x04, 0xc0, 0xb1, 0xb2, 0x60, 0x04, 0x74, 0x77, 0xaa, 0xcc, 0x7c, 0x03, 0x04,
+    0xe2, 0xe4, 0xe8, 0xb2, 0x04, 0xe0, 0x77, 0xaa, 0xcc, 0x7d, 0x03, 0x04, 0xe2, 0xe4, 0x90, 0xe8,
+    0x04, 0xf1, 0x77, 0xaa, 0xcc, 0x7e, 0x03, 0x04, 0xe8, 0xd1, 0xb2, 0xe4, 0x04, 0xf0, 0x77, 0xaa,
+    0xcc, 0xc0, 0x03, 0x02, 0xe6, 0xe8, 0x03, 0xc0, 0x64, 0xaa, 0xc1, 0x03, 0x03, 0x70, 0xe6, 0xe8,
+    0x04, 0x62, 0x64, 0xd1, 0xaa, 0xc3, 0x03, 0x02, 0x60, 0xe6, 0x03, 0x62, 0x64, 0xaa, 0xc5, 0x03,
+    0x03, 0xe6, 0xe8, 0xd0, 0x03, 0x64, 0xaa, 0xd1, 0xc6, 0x03, 0x04, 0x71, 0xb2, 0xe6, 0xe8, 0x04,
+    0xb0, 0x73, 0x64, 0xaa, 0xc7, 0x03, 0x03, 0x60, 0xe6, 0xd0, 0x03, 0x73, 0x64, 0xaa, 0xcf, 0x03,
+    0x02, 0xa2, 0x60, 0x02, 0x64, 0xaa, 0xd4, 0x03, 0x04, 0xb2, 0xd4, 0xe6, 0xe8, 0x05, 0xe0, 0xaa,
+    0xcc, 0xd1, 0xb1, 0xd5, 0x03, 0x03, 0x90, 0xe6, 0xe8, 0x04, 0xaa, 0xcc, 0xd1, 0xb1, 0xd6, 0x03,
+    0x05, 0x71, 0xb2, 0xd4, 0xe6, 0xe8, 0x05, 0xf0, 0x73, 0x75, 0xaa, 0xcc, 0xd7, 0x03, 0x03, 0x60,
+    0x90, 0xe6, 0x04, 0x73, 0x75, 0xaa, 0xcc, 0xd8, 0x03, 0x03, 0xb3, 0xd4, 0xe8, 0x04, 0xaa, 0xcc,
+    0xd0, 0xb1, 0xd9, 0x03, 0x04, 0xb3, 0xe8, 0xb0, 0xd4, 0x04, 0xb1, 0x72, 0xaa, 0xcc, 0xdb, 0x03,
+    0x03, 0x60, 0xb3, 0xd4, 0x04, 0x72, 0x75, 0xaa, 0xcc, 0xdc, 0x03, 0x03, 0xa2, 0xd4, 0xe8, 0x04,
+    0xe0, 0xaa, 0xcc, 0xb1, 0xdd, 0x03, 0x03, 0xa2, 0x90, 0xe8, 0x03, 0xb1, 0xaa, 0xcc, 0xde, 0x03,
+    0x04, 0xa2, 0xd4, 0xe8, 0xd1, 0x04, 0xf0, 0x75, 0xaa, 0xcc, 0xfc, 0x03, 0x03, 0xa2, 0xc4, 0xe8,
+    0x03, 0xe0, 0xaa, 0xcc, 0x60, 0x06, 0x04, 0xf5, 0xf6, 0xf9, 0xfa, 0x04, 0xc0, 0x30, 0x33, 0xcc,
+    0x61, 0x06, 0x05, 0xf0, 0xf5, 0xf6, 0xf9, 0xfa, 0x06, 0xd1, 0xe2, 0x74, 0x33, 0xb8, 0xcc, 0x62,
+    0x06, 0x04, 0xb1, 0xf6, 0x71, 0xfa, 0x04, 0x30, 0x33, 0xcc, 0xd0, 0x63, 0x06, 0x05, 0xe0, 0xb1,
+    0xf6, 0x71, 0xfa, 0x05, 0xe2, 0x74, 0x33, 0xb8, 0xcc, 0x66, 0x06, 0x04, 0xb1, 0xb2, 0x71, 0x72,
+    0x03, 0x30, 0x33, 0xcc, 0x67, 0x06, 0x05, 0xb1, 0xb2, 0x71, 0x72, 0xe0, 0x04, 0x33, 0x74, 0xb8,
+    0xcc, 0x69, 0x06, 0x06, 0xf0, 0xf3, 0xf5, 0xf6, 0xf9, 0xfa, 0x07, 0xf1, 0xf2, 0x74, 0x77, 0xb8,
+    0xbb, 0xcc, 0x6b, 0x06, 0x06, 0xe0, 0xd1, 0xb1, 0xf6, 0x71, 0xfa, 0x06, 0xf2, 0x74, 0x77, 0xb8,
+    0xbb, 0xcc, 0x6f, 0x06, 0x05, 0xc0, 0xb1, 0xb2, 0x71, 0x72, 0x05, 0x74, 0x77, 0xb8, 0xbb, 0xcc,
+    0x72, 0x06, 0x04, 0xd4, 0x71, 0xfa, 0xb1, 0x04, 0x33, 0xcc, 0xd0, 0x70, 0x73, 0x06, 0x04, 0xa0,
+    0xd4, 0x71, 0xfa, 0x04, 0xe2, 0x33, 0xb8, 0xcc, 0x76, 0x06, 0x04, 0x71, 0x72, 0xe4, 0xd4, 0x03,
+    0x70, 0x33, 0xcc, 0x78, 0x06, 0x05, 0xf3, 0xe4, 0xd4, 0xf9, 0xfa, 0x06, 0xe0, 0xd0, 0x77, 0xbb,
+    0xcc, 0x70, 0x79, 0x06, 0x06, 0xb0, 0xf3, 0xe4, 0xd4, 0xf9, 0xfa, 0x06, 0xf1, 0xf2, 0x77, 0xb8,
+    0xbb, 0xcc, 0x7a, 0x06, 0x05, 0xd1, 0xd4, 0x71, 0xfa, 0xb1, 0x05, 0xd0, 0x77, 0xbb, 0xcc, 0x70,
+    0x7b, 0x06, 0x05, 0xa0, 0xd1, 0xd4, 0x71, 0xfa, 0x05, 0xf2, 0x77, 0xb8, 0xbb, 0xcc, 0x7e, 0x06,
+    0x05, 0x71, 0x72, 0xd1, 0xe4, 0xd4, 0x04, 0x70, 0x77, 0xbb, 0xcc, 0x90, 0x06, 0x04, 0xf4, 0xf7,
+    0xf9, 0xfa, 0x05, 0xc0, 0x75, 0x76, 0xb8, 0xbb, 0x91, 0x06, 0x04, 0xb0, 0xf7, 0xf9, 0xfa, 0x05,
+    0xb8, 0xb1, 0xb2, 0x73, 0xcc, 0x93, 0x06, 0x04, 0xb0, 0xf7, 0x71, 0xfa, 0x05, 0x75, 0xb8, 0xb2,
+    0x73, 0xcc, 0x96, 0x06, 0x04, 0x71, 0x72, 0xf4, 0xf7, 0x05, 0x70, 0x73, 0x75, 0x76, 0xcc, 0x97,
+    0x06, 0x04, 0xb0, 0xf7, 0x71, 0x72, 0x05, 0x73, 0x75, 0x76, 0xb8, 0xcc, 0x9f, 0x06, 0x04, 0xb0,
+    0xb3, 0x71, 0x72, 0x04, 0x75, 0x76, 0xb8, 0xbb, 0xb0, 0x06, 0x04, 0xe4, 0xd5, 0xf9, 0xfa, 0x05,
+    0xc0, 0xcc, 0xb2, 0x70, 0x73, 0xb1, 0x06, 0x04, 0xb0, 0xd5, 0xf9, 0xfa, 0x05, 0xd1, 0xb8, 0xcc,
+    0xb2, 0x73, 0xb2, 0x06, 0x04, 0xe4, 0xd5, 0x71, 0xfa, 0x04, 0xcc, 0xb2, 0x70, 0x73, 0xb3, 0x06,
+    0x04, 0xa0, 0xd5, 0x71, 0xfa, 0x04, 0xb8, 0xcc, 0xb2, 0x73, 0xb4, 0x06, 0x04, 0x72, 0xe4, 0xd5,
+    0xf9, 0x05, 0x76, 0xcc, 0x70, 0x73, 0xe0, 0xb5, 0x06, 0x04, 0xd5, 0xf9, 0x72, 0xb0, 0x05, 0xd1,
+    0x76, 0xb8, 0xcc, 0x73, 0xb6, 0x06, 0x04, 0x72, 0xe4, 0xd5, 0x71, 0x04, 0x70, 0x73, 0x76, 0xcc,
+    0xb7, 0x06, 0x04, 0xa0, 0xd5, 0x71, 0x72, 0x04, 0x73, 0x76, 0xb8, 0xcc, 0xb9, 0x06, 0x05, 0xb0,
+    0xb3, 0xf9, 0xfa, 0xe4, 0x05, 0xf1, 0xb2, 0xb8, 0xbb, 0xcc, 0xbd, 0x06, 0x05, 0xf9, 0x72, 0xb0,
+    0xb3, 0xe4, 0x05, 0xf1, 0x76, 0xb8, 0xbb, 0xcc, 0xf0, 0x06, 0x03, 0xc4, 0xf9, 0xfa, 0x04, 0xc0,
+    0xcc, 0x70, 0x73, 0xf1, 0x06, 0x04, 0xb0, 0xc4, 0xf9, 0xfa, 0x05, 0xd1, 0xe2, 0xb8, 0xcc, 0x73,
+    0xf2, 0x06, 0x03, 0xc4, 0x71, 0xfa, 0x04, 0xcc, 0x70, 0x73, 0xd0, 0xf6, 0x06, 0x03, 0xc4, 0x71,
+    0x72, 0x03, 0x70, 0x73, 0xcc, 0xf9, 0x06, 0x05, 0xb0, 0xb3, 0xc4, 0xf9, 0xfa, 0x05, 0xf1, 0xf2,
+    0xb8, 0xbb, 0xcc, 0x76, 0x07, 0x04, 0xb1, 0x72, 0xd4, 0xe8, 0x03, 0xf0, 0x33, 0xcc, 0x78, 0x07,
+    0x05, 0xf3, 0xe4, 0xd4, 0xe8, 0xd8, 0x05, 0xe0, 0xd0, 0x77, 0xbb, 0xcc, 0x79, 0x07, 0x06, 0xf3,
+    0xe4, 0xd4, 0xe8, 0xd8, 0xb0, 0x05, 0xf1, 0xf2, 0x77, 0xbb, 0xcc, 0x7a, 0x07, 0x05, 0xd1, 0xd4,
+    0xd8, 0xb1, 0x71, 0x04, 0xd0, 0x77, 0xbb, 0xcc, 0x7e, 0x07, 0x05, 0xd1, 0xe4, 0xb2, 0xe8, 0x72,
+    0x04, 0xf0, 0x77, 0xbb, 0xcc, 0xb0, 0x07, 0x04, 0xe4, 0xd5, 0xe8, 0xd8, 0x04, 0xc0, 0xcc, 0xb2,
+    0x73, 0xb1, 0x07, 0x04, 0xd5, 0xe8, 0xd8, 0xb0, 0x04, 0xd1, 0xcc, 0xb2, 0x73, 0xb4, 0x07, 0x04,
+    0x72, 0xe4, 0xd5, 0xe8, 0x04, 0xe0, 0x76, 0xcc, 0x73, 0xb5, 0x07, 0x04, 0x50, 0xd5, 0xe8, 0xb0,
+    0x04, 0xd1, 0x76, 0xcc, 0x73, 0xb6, 0x07, 0x05, 0x72, 0xe4, 0xd5, 0x71, 0xe8, 0x04, 0xf0, 0x73,
+    0x76, 0xcc, 0xbc, 0x07, 0x04, 0xe4, 0xe8, 0xb3, 0x72, 0x04, 0xe0, 0x76, 0xbb, 0xcc, 0xe0, 0x07,
+    0x04, 0xd5, 0xe6, 0xe8, 0xd8, 0x04, 0xc0, 0xcc, 0xb0, 0x73, 0xe1, 0x07, 0x05, 0x70, 0xd5, 0xe6,
+    0xe8, 0xd8, 0x05, 0xd1, 0xe2, 0x74, 0xcc, 0x73, 0xe2, 0x07, 0x04, 0xe6, 0xd8, 0xb1, 0x71, 0x04,
+    0xcc, 0xb0, 0x73, 0xd0, 0xe3, 0x07, 0x04, 0x60, 0xe6, 0xd8, 0xb1, 0x04, 0xe2, 0x74, 0xcc, 0x73,
+    0xe6, 0x07, 0x04, 0xb1, 0x72, 0xe6, 0xe8, 0x03, 0xb0, 0x73, 0xcc, 0xe9, 0x07, 0x06, 0x70, 0xb3,
+    0xd5, 0xe6, 0xe8, 0xd8, 0x05, 0xf1, 0xf2, 0x74, 0xbb, 0xcc, 0xf0, 0x07, 0x03, 0xc4, 0xe8, 0xd8,
+    0x03, 0xc0, 0xcc, 0x73, 0xf1, 0x07, 0x04, 0xc4, 0xe8, 0xd8, 0xb0, 0x04, 0xd1, 0xe2, 0xcc, 0x73,
+    0xf2, 0x07, 0x03, 0xc4, 0xd8, 0x71, 0x03, 0xd0, 0xcc, 0x73, 0xf8, 0x07, 0x04, 0xb3, 0xc4, 0xe8,
+    0xd8, 0x04, 0xe0, 0xd0, 0xbb, 0xcc, 0xf0, 0x0f, 0x02, 0xc4, 0xc8, 0x02, 0xc0, 0xcc, 0x68, 0x16,
+    0x06, 0xf3, 0xf5, 0xf6, 0xf9, 0xfa, 0xfc, 0x08, 0xe0, 0xd0, 0xb0, 0x77, 0x70, 0xbb, 0xdd, 0xee,
+    0x69, 0x16, 0x07, 0xf0, 0xf3, 0xf5, 0xf6, 0xf9, 0xfa, 0xfc, 0x08, 0xf1, 0xf2, 0xf4, 0x77, 0xf8,
+    0xbb, 0xdd, 0xee, 0x6a, 0x16, 0x06, 0xd1, 0xb1, 0xf6, 0x71, 0xfa, 0xfc, 0x07, 0xd0, 0xb0, 0x77,
+    0x70, 0xbb, 0xdd, 0xee, 0x6b, 0x16, 0x07, 0xe0, 0xd1, 0xb1, 0xf6, 0x71, 0xfa, 0xfc, 0x07, 0xf2,
+    0xf4, 0x77, 0xf8, 0xbb, 0xdd, 0xee, 0x6e, 0x16, 0x06, 0xb1, 0xb2, 0x71, 0x72, 0xfc, 0xd1, 0x06,
+    0xb0, 0x77, 0x70, 0xbb, 0xdd, 0xee, 0x7e, 0x16, 0x06, 0x71, 0x72, 0x74, 0xd1, 0xb1, 0xb2, 0x05,
+    0x70, 0x77, 0xbb, 0xdd, 0xee, 0x81, 0x16, 0x05, 0xf0, 0xf7, 0xf9, 0xfa, 0xfc, 0x07, 0xf8, 0xd1,
+    0xe2, 0xe4, 0x73, 0xdd, 0x76, 0x83, 0x16, 0x05, 0xe0, 0xf7, 0x71, 0xfa, 0xfc, 0x06, 0xf8, 0xe2,
+    0xe4, 0x73, 0xdd, 0x76, 0x86, 0x16, 0x04, 0x71, 0x72, 0xf7, 0xfc, 0x05, 0x73, 0x70, 0xe4, 0x76,
+    0xdd, 0x87, 0x16, 0x05, 0xf7, 0x71, 0x72, 0xfc, 0xe0, 0x05, 0x73, 0xf8, 0xe4, 0x76, 0xdd, 0x89,
+    0x16, 0x05, 0xf0, 0xb3, 0xf9, 0xfa, 0xfc, 0x07, 0xb1, 0xb2, 0xf8, 0xbb, 0xe4, 0x75, 0x76, 0x8b,
+    0x16, 0x05, 0xe0, 0xb3, 0x71, 0xfa, 0xfc, 0x06, 0xb2, 0xf8, 0xbb, 0xe4, 0x75, 0x76, 0x8e, 0x16,
+    0x04, 0xb3, 0x71, 0x72, 0xfc, 0x05, 0x70, 0xbb, 0x75, 0x76, 0xe4, 0x96, 0x16, 0x04, 0x71, 0x72,
+    0x74, 0xf7, 0x05, 0x70, 0x73, 0x75, 0x76, 0xbb, 0x97, 0x16, 0x05, 0xf7, 0x71, 0x72, 0x74, 0xe0,
+    0x05, 0x73, 0x75, 0x76, 0xf8, 0xbb, 0x98, 0x16, 0x04, 0xb3, 0x74, 0xf9, 0xfa, 0x06, 0x70, 0xbb,
+    0xb1, 0xb2, 0x75, 0x76, 0x99, 0x16, 0x05, 0xb0, 0xb3, 0xf9, 0xfa, 0x74, 0x06, 0xb1, 0xb2, 0xf8,
+    0xbb, 0x75, 0x76, 0x9a, 0x16, 0x04, 0x74, 0xb3, 0x71, 0xfa, 0x05, 0x75, 0x70, 0xbb, 0xb2, 0x76,
+    0x9b, 0x16, 0x05, 0xb3, 0x71, 0xfa, 0x74, 0xe0, 0x05, 0xb2, 0x75, 0xf8, 0xbb, 0x76, 0x9e, 0x16,
+    0x04, 0x74, 0xb3, 0x71, 0x72, 0x04, 0x70, 0x75, 0x76, 0xbb, 0xa9, 0x16, 0x06, 0xf0, 0xb3, 0xd5,
+    0xf9, 0xfa, 0xfc, 0x07, 0xf1, 0xb2, 0xd4, 0xf8, 0xbb, 0xdd, 0x76, 0xac, 0x16, 0x05, 0xd5, 0xf9,
+    0x72, 0xfc, 0xe2, 0x06, 0xe0, 0x70, 0xbb, 0xdd, 0xd4, 0x76, 0xad, 0x16, 0x06, 0xd0, 0xd5, 0xf9,
+    0x72, 0xfc, 0xe2, 0x06, 0xf1, 0xd4, 0xf8, 0xbb, 0xdd, 0x76, 0xbc, 0x16, 0x05, 0xf9, 0x72, 0x74,
+    0xb3, 0xd5, 0x05, 0xe0, 0x76, 0x70, 0xbb, 0xdd, 0xe9, 0x16, 0x07, 0xf0, 0xb3, 0xd5, 0xe6, 0xf9,
+    0xfa, 0xfc, 0x07, 0xf1, 0xf2, 0xf4, 0xf8, 0xbb, 0xdd, 0xee, 0x7e, 0x17, 0x06, 0xd1, 0xb1, 0xb2,
+    0x71, 0xd8, 0x74, 0x05, 0xf0, 0x77, 0xbb, 0xdd, 0xee, 0x8e, 0x17, 0x04, 0xb3, 0xb8, 0x71, 0x72,
+    0x04, 0xb0, 0xbb, 0x75, 0x76, 0x96, 0x17, 0x05, 0x71, 0x72, 0x74, 0xf7, 0xe8, 0x05, 0xf0, 0x73,
+    0x75, 0x76, 0xbb, 0x98, 0x17, 0x04, 0xb3, 0x74, 0xe8, 0xd8, 0x05, 0xbb, 0x75, 0x76, 0xe0, 0xd0,
+    0x9a, 0x17, 0x04, 0x74, 0xb3, 0xd8, 0x71, 0x04, 0xd0, 0x75, 0xbb, 0x76, 0xac, 0x17, 0x05, 0xd5,
+    0xe8, 0xb8, 0xe2, 0x72, 0x05, 0xe0, 0xbb, 0xdd, 0xd4, 0x76, 0xe8, 0x17, 0x06, 0xb3, 0xd5, 0xe6,
+    0xe8, 0xd8, 0xb8, 0x06, 0xe0, 0xd0, 0xb0, 0xbb, 0xdd, 0xee, 0xe7, 0x18, 0x05, 0xfb, 0xfc, 0xe0,
+    0xb2, 0xd5, 0x05, 0xf3, 0xf4, 0xe8, 0xba, 0xdd, 0xe1, 0x19, 0x05, 0x70, 0xd5, 0xe6, 0xfb, 0xb8,
+    0x05, 0xf4, 0xd1, 0x72, 0xb9, 0xee, 0xe3, 0x19, 0x05, 0xe6, 0xfb, 0xb8, 0xe0, 0xb1, 0x05, 0xe2,
+    0xf4, 0xb9, 0xba, 0xee, 0xe6, 0x19, 0x05, 0xb1, 0xb2, 0xb8, 0xfb, 0xd5, 0x05, 0xb0, 0xf3, 0xb9,
+    0xba, 0xdd, 0xd8, 0x1b, 0x04, 0xb3, 0xd4, 0xb8, 0xd9, 0x04, 0xe0, 0x72, 0x75, 0xee, 0xe4, 0x1b,
+    0x04, 0xb2, 0xd5, 0xd9, 0xb8, 0x04, 0xd1, 0xb0, 0xba, 0xdd, 0xe1, 0x1e, 0x06, 0xf0, 0xd5, 0xe6,
+    0xd9, 0xea, 0xfc, 0x06, 0xd1, 0xe2, 0xf4, 0xf8, 0xdd, 0xee, 0xc3, 0x3c, 0x04, 0xe0, 0xe6, 0xea,
+    0xec, 0x04, 0xe2, 0xe4, 0xe8, 0xee, 0x96, 0x69, 0x08, 0xf1, 0xf2, 0xf4, 0xf7, 0xf8, 0xfb, 0xfd,
+    0xfe, 0x08, 0xf0, 0xf3, 0xf5, 0xf6, 0xf9, 0xfa, 0xfc, 0xff,
+};
+
+// NPN database lookup
+// Functions of up to 4 variables without don't-cares. The canonical table is found by binary search
+// over the class offsets, and its cover (or its complement's) is mapped back through the transform
+bool npn(int n, const std::vector<uint64_t>& onb, std::vector<Cube>& cv) {
+    static std::vector<uint16_t> ofs;
+    static std::once_flag flg;
+    std::call_once(flg, []() {
+        for (size_t i = 0; i < sizeof(npndb); ) {
+            ofs.emplace_back(i);
+            i += 2;
+            i += npndb[i] + 1;
+            i += npndb[i] + 1;
+        }
+    });
+    if (n > 4 || ofs.empty())
+        return false;
+    Phase ph("npn");
+    uint16_t t = 0;
+    for (int x = 0; x < 16; ++x)
+        t |= ((onb[0] >> (x & ((1 << n) - 1))) & 1) << x;
+    int p[4], m, o;
+    uint16_t c = npnC(t, p, m, o);
+    auto it = std::lower_bound(ofs.begin(), ofs.end(), c, [](uint16_t i, uint16_t c) {
+        return (npndb[i] | npndb[i + 1] << 8) < c;
+    });
+    if (it == ofs.end() || (npndb[*it] | npndb[*it + 1] << 8) != c)
+        return false;
+    // Literal on y bit j is on x bit p[j], its value flipped by m
+    const uint8_t *b = npndb + *it + 2;
+    if (o)
+        b += *b + 1;
+    cv.clear();
+    for (int k = 1; k <= *b; ++k) {
+        Cube x = {0, 0};
+        for (int j = 0; j < 4; ++j)
+            if ((b[k] >> (4 + j)) & 1) {
+                x.c |= 1u << p[j];
+                x.v |= (((b[k] >> j) & 1) ^ ((m >> p[j]) & 1)) << p[j];
+            }
+        cv.emplace_back(x);
+    }
+    return true;
+}
+
+// Generate NPN class database
+// Prints npndb, covers come from the exact matrix cover
+int npnGen() {
+    std::set<uint16_t> cls;
+    for (int t = 0; t < 65536; ++t) {
+        int p[4], m, o;
+        cls.insert(npnC(t, p, m, o));
+    }
+    std::vector<uint8_t> db;
+    ocover = "exact";
+    for (auto &c : cls) {
+        db.emplace_back(c & 255);
+        db.emplace_back(c >> 8);
+        for (uint16_t t : {c, (uint16_t)~c}) {
+            std::vector<size_t> ons;
+            std::vector<uint64_t> onb(1, t);
+            for (int x = 0; x < 16; ++x)
+                if ((t >> x) & 1)
+                    ons.emplace_back(x);
+            std::vector<Cube> cv;
+            bool opt;
+            if (ons.size())
+                cv = cover(4, gpr(4, ons, {}), onb, opt);
+            db.emplace_back(cv.size());
+            for (auto &x : cv)
+                db.emplace_back(x.c << 4 | x.v);
+        }
+    }
+    std::printf("// %zu classes, %zu bytes\n", cls.size(), db.size());
+    for (size_t i = 0; i < db.size(); ++i)
+        std::printf("%s0x%02x,%s", i % 16 ? " " : "    ", db[i], i % 16 == 15 || i + 1 == db.size() ? "\n" : "");
+    return 0;
+}
+
+// Engine selection
+// Cheapest applicable engine first: NPN table and single word for small functions, unate and affine
+// functions directly, expansion when the spectrum predicts too many primes, else prime generation
+// and cover. The spectrum costs a few passes over the table, for large XOR-free expressions it is
+// skipped. A forced engine is used if it applies. Returns the engine, why holds the reason
+std::string pick(int n, const std::vector<uint64_t>& onb, bool dc, uint32_t& neg, Spec& sp, std::string& why) {
+    char buf[96];
+    auto ok = [&](const std::string& e) {
+        return oengine == "auto" || oengine == e;
+    };
+    if (ok("npn") && n <= 4 && !dc) {
+        why = "at most 4 variables, NPN class table";
+        return "npn";
+    }
+    if (ok("word") && n <= 6) {
+        why = "at most 6 variables, truth table in one word";
+        return "word";
+    }
+    if (ok("unate") && !dc && (mono || unate(n, onb, neg))) {
+        why = mono ? "expression without NOT and XOR" : "unate ON set";
+        return "unate";
+    }
+    if (ok("affine") && !dc && n <= 20 && (oengine != "auto" || nxor || n <= 14)) {
+        sp = spec(n, onb);
+        if (sp.aff) {
+            std::snprintf(buf, sizeof(buf), "parity of %d variables", __builtin_popcount(sp.afm));
+            why = buf;
+            return "affine";
+        }
+        if (oengine == "auto" && sp.prm > (1 << 22)) {
+            std::snprintf(buf, sizeof(buf), "~%.3g primes estimated", sp.prm);
+            why = buf;
+            return "expand";
+        }
+    }
+    if (oengine == "expand") {
+        why = "forced";
+        return "expand";
+    }
+    if (oengine != "auto" && oengine != "qm")
+        why = "'" + oengine + "' does not apply, ";
+    else
+        why.clear();
+    std::snprintf(buf, sizeof(buf), "%d variables, ON density %.3g", n, ccount({0, 0}, n, onb) / std::ldexp(1, n));
+    why += buf;
+    return "qm";
+}
+
+// Quine-McCluskey Algorithm
+// Don't-care minterms take part in merging but needn't be covered.
+// The engine is picked per function, those besides qm and expand give minimum covers directly
+std::vector<std::string> QMA(int n, const std::vector<size_t>& ons, const std::vector<size_t>& dcs) {
+    std::vector<uint64_t> onb((((size_t)1 << n) + 63) / 64, 0), dcb(onb.size(), 0);
+    for (auto &i : ons)
+        onb[i >> 6] |= 1ull << (i & 63);
+    for (auto &i : dcs)
+        dcb[i >> 6] |= 1ull << (i & 63);
+    uint32_t neg = 0;
+    Spec sp = {};
+    std::string why, eng = pick(n, onb, dcs.size(), neg, sp, why);
+    if (ostats)
+        notes.emplace_back("engine " + eng + ": " + why);
+    if (oimprove > 0 && eng == "expand")
+        std::cerr << "[WARN] --improve only applies to the qm engine, not to expand" << std::endl;
+    else if (oimprove > 0 && eng != "qm" && ostats)
+        notes.emplace_back("improve: skipped, engine " + eng + " gives a minimum cover");
+    std::vector<Cube> cv;
+    if (eng == "npn")
+        npn(n, onb, cv);
+    else if (eng == "word") {
+        Cube tmp[64];
+        size_t k = wcover(n, onb[0], dcb[0], tmp);
+        cv.assign(tmp, tmp + k);
+    }
+    else if (eng == "unate")
+        cv = mtp(n, onb, neg);
+    else if (eng == "affine")
+        cv = affine(sp);
+    else if (eng == "expand") {
+        std::vector<uint64_t> cb(onb);
+        for (size_t w = 0; w < cb.size(); ++w)
+            cb[w] |= dcb[w];
+        cv = expand(n, onb, cb);
+        if (ostats)
+            notes.emplace_back("engine expand: heuristic cover, not proven minimum");
+    }
+    else {
+        std::vector<uint32_t> grp;
+        if (oprimes == "symmetry" || oprimes == "auto")
+            grp = symm(n, onb, dcb);
+        std::vector<Cube> prm;
+        if (grp.size() && symmetric(grp, oprimes == "symmetry"))
+            prm = psym(onb, dcb, grp);
+        else if (oprimes == "consensus" || (oprimes != "merge" && sparse(n, ons, dcs, onb, dcb)))
+            prm = pcons(n, ons, dcs);
+        else
+            prm = gpr(n, ons, dcs);
+        bool opt;
+        cv = cover(n, prm, onb, opt);
+        if (oimprove > 0 && !opt)
+            improve(n, prm, onb, cv, oimprove);
+        else if (oimprove > 0 && ostats)
+            notes.emplace_back("improve: skipped, exact cover is minimum");
+    }
+    if (obound && eng == "expand") {
+        std::vector<uint64_t> cb(onb);
+        for (size_t w = 0; w < cb.size(); ++w)
+            cb[w] |= dcb[w];
+        blb += indep(n, onb, cb);
+    }
+    else if (obound && eng != "qm")
+        blb += cv.size();
+    absorb(cv);
+    bterms += cv.size();
+    std::vector<std::string> rtn;
+    for (auto &i : cv)
+        rtn.emplace_back(toStr(i, n));
+    return rtn;
+}
+
+// Assert
+void ast(const std::string& err, std::stack<OpNode*>& stk) {
+    // Clear stack
+    while (!stk.empty()) {
+        delete stk.top();
+        stk.pop();
+    }
+    // Output error
+    std::cerr << err << std::endl;
+}
+
+// Parse expression into abstract syntax tree
+// O(N)
+bool parse() {
+    Phase ph("parse");
+    // Map variables to row bits, first variable is the highest bit
+    int cnt = var.size();
+    for (auto &i : var)
+        mvar[i] = --cnt;
+    // Get reverse polish notation
+    std::string rpn = cvtRPN(cvtAL(input));
+    if (rpn[0] == '[') {
+        std::cerr << rpn << std::endl;
+        return false;
+    }
+    // Get abstract syntax tree
+    std::stack<OpNode*> stk;
+    auto errout = std::bind(ast, std::placeholders::_1, stk);
+    for (auto &i : rpn)
+        if (isupper(i))
+            stk.emplace(new VarNode(i));
+        else if (isdigit(i))
+            stk.emplace(new VarNode(i - '0'));
+        else if (i == '\'') {
+            if (stk.size() < 1) {
+                errout("[ERROR] Invalid NOT logic");
+                return false;
+            }
+            NotNode *tmp = new NotNode();
+            tmp->l = stk.top();
+            stk.pop();
+            stk.emplace(tmp);
+        }
+        else if (i == '*') {
+            if (stk.size() < 2) {
+                errout("[ERROR] Invalid AND logic");
+                return false;
+            }
+            AndNode *tmp = new AndNode();
+            tmp->l = stk.top();
+            stk.pop();
+            tmp->r = stk.top();
+            stk.pop();
+            stk.emplace(tmp);
+        }
+        else if (i == '^') {
+            if (stk.size() < 2) {
+                errout("[ERROR] Invalid XOR logic");
+                return false;
+            }
+            XorNode *tmp = new XorNode();
+            tmp->l = stk.top();
+            stk.pop();
+            tmp->r = stk.top();
+            stk.pop();
+            stk.emplace(tmp);
+        }
+        else if (i == '+') {
+            if (stk.size() < 2) {
+                errout("[ERROR] Invalid OR logic");
+                return false;
+            }
+            OrNode *tmp = new OrNode();
+            tmp->l = stk.top();
+            stk.pop();
+            tmp->r = stk.top();
+            stk.pop();
+            stk.emplace(tmp);
+        }
+        else {
+            errout("[ERROR] Invalid logic");
+            return false;
+        }
+    if (stk.size() > 1) {
+        errout("[ERROR] Invalid logic");
+        return false;
+    }
+    root.l = stk.top();
+    return true;
+}
+
+// Analyze
+void analyze() {
+    if (!parse())
+        return;
+    // Without NOT and XOR the expression is monotone
+    mono = input.find_first_of("'^") == std::string::npos;
+    nxor = std::count(input.begin(), input.end(), '^');
+    std::cout << std::endl;
+    // If is constant expression
+    if (var.size() == 0) {
+        std::cout << "Constant expression:\nY = " << root.get(0) << std::endl;
+        return;
+    }
+    // Output true value table
     tvt();
     // Output minimum expression
-    std::cout << "\nY = m("; 
+    if (otable)
+        std::cout << std::endl;
+    std::cout << "Y = m("; 
     for (size_t i = 0; i < m.size(); ++i) {
         if (i)
             std::cout << ',';
@@ -473,36 +3370,753 @@ void analyze() {
     }
     std::cout << ")\n" << std::endl;
     // Output simplified expression
-    if (m.size() == 0) {
+    std::vector<std::string> sl, nms;
+    for (auto &i : var)
+        nms.emplace_back(1, i);
+    if (m.size() == 0)
         std::cout << "Y = 0" << std::endl;
-        return;
-    }
-    if (m.size() == (1 << var.size())) {
+    else if (m.size() == (1ull << var.size())) {
+        sl.emplace_back(var.size(), '-');
         std::cout << "Y = 1" << std::endl;
-        return;
     }
-    auto sl = QMA();
-    std::cout << "Y = ";
+    else {
+        sl = QMA(var.size(), m, {});
+        std::cout << "Y = " << sop(sl, nms) << std::endl;
+    }
+    if (opla.size())
+        writePla(opla, nms, {"Y"}, {sl});
+    if (oblif.size())
+        writeBlif(oblif, nms, {"Y"}, {sl});
+}
+
+// Sum of products
+// Terms are sorted, literals are joined by '*' if any name is longer than a letter
+std::string sop(const std::vector<std::string>& sl, const std::vector<std::string>& nms) {
+    if (sl.empty())
+        return "0";
+    bool lng = false;
+    for (auto &i : nms)
+        lng |= i.size() > 1;
     std::vector<std::string> lss;
-    for (size_t i = 0; i < sl.size(); ++i) {
+    for (auto &i : sl) {
         std::string tmp;
-        int cnt = 0;
-        for (auto &j : var) {
-            if (sl[i][cnt] == '0') {
-                tmp += j;
-                tmp += '\'';
+        for (size_t j = 0; j < nms.size(); ++j)
+            if (i[j] != '-') {
+                if (lng && tmp.size())
+                    tmp += '*';
+                tmp += nms[j];
+                if (i[j] == '0')
+                    tmp += '\'';
             }
-            else if (sl[i][cnt] == '1')
-                tmp += j;
-            ++cnt;
-        }
-        lss.emplace_back(tmp);
+        lss.emplace_back(tmp.empty() ? "1" : tmp);
     }
     std::sort(lss.begin(), lss.end());
+    std::string rtn;
     for (size_t i = 0; i < lss.size(); ++i) {
         if (i)
-            std::cout << '+';
-        std::cout << lss[i];
+            rtn += '+';
+        rtn += lss[i];
     }
-    std::cout << std::endl;
+    return rtn;
+}
+
+// Read PLA file
+// Output columns: '1' ON, '0' OFF (fr, fdr), '-' or '2' don't-care (fd, fdr), '~' nothing
+bool readPla(const std::string& file, int& ni, std::vector<std::string>& ilb, std::vector<std::string>& ob,
+             std::vector<std::vector<uint64_t>>& ons, std::vector<std::vector<uint64_t>>& dcs) {
+    std::ifstream fin(file);
+    if (!fin) {
+        std::cerr << "[ERROR] Cannot read PLA file '" << file << '\'' << std::endl;
+        return false;
+    }
+    int no = -1;
+    std::string typ = "fd", line;
+    std::vector<std::vector<uint64_t>> ofs;
+    ni = -1;
+    auto err = [&](const std::string& msg) {
+        std::cerr << "[ERROR] " << file << ": " << msg << std::endl;
+        return false;
+    };
+    while (std::getline(fin, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream sin(line);
+        std::string key;
+        if (!(sin >> key))
+            continue;
+        if (key[0] == '.') {
+            if (key == ".i") {
+                if (!(sin >> ni) || ni < 0 || ni > 26)
+                    return err("Number of inputs must be in 0..26");
+            }
+            else if (key == ".o") {
+                if (!(sin >> no) || no < 0)
+                    return err("Invalid number of outputs");
+            }
+            else if (key == ".ilb")
+                for (std::string tmp; sin >> tmp; )
+                    ilb.emplace_back(tmp);
+            else if (key == ".ob")
+                for (std::string tmp; sin >> tmp; )
+                    ob.emplace_back(tmp);
+            else if (key == ".type")
+                sin >> typ;
+            else if (key == ".e" || key == ".end")
+                break;
+            else if (key != ".p")
+                return err("Unsupported directive '" + key + "'");
+            if (typ != "f" && typ != "fd" && typ != "fr" && typ != "fdr")
+                return err("Unsupported type '" + typ + "'");
+            continue;
+        }
+        if (ni < 0 || no < 0)
+            return err("Cube before .i and .o");
+        if (ons.empty()) {
+            size_t wds = (((size_t)1 << ni) + 63) / 64;
+            ons.assign(no, std::vector<uint64_t>(wds, 0));
+            dcs = ofs = ons;
+        }
+        // Cube row, input and output parts may be separated by spaces
+        std::string row;
+        for (auto &i : line)
+            if (!isspace(i))
+                row += i;
+        if (row.size() != (size_t)(ni + no))
+            return err("Invalid cube '" + line + "'");
+        size_t v = 0, fre = 0;
+        for (int i = 0; i < ni; ++i) {
+            size_t bit = (size_t)1 << (ni - 1 - i);
+            if (row[i] == '1')
+                v |= bit;
+            else if (row[i] == '-' || row[i] == '2')
+                fre |= bit;
+            else if (row[i] != '0')
+                return err("Invalid cube '" + line + "'");
+        }
+        for (int j = 0; j < no; ++j) {
+            char c = row[ni + j];
+            std::vector<uint64_t> *tgt = nullptr;
+            if (c == '1' || c == '4')
+                tgt = &ons[j];
+            else if ((c == '-' || c == '2') && typ != "f" && typ != "fr")
+                tgt = &dcs[j];
+            else if ((c == '0' || c == '3') && typ.back() == 'r')
+                tgt = &ofs[j];
+            if (!tgt)
+                continue;
+            // Enumerate minterms of the cube
+            for (size_t s = 0; ; s = (s - fre) & fre) {
+                (*tgt)[(v | s) >> 6] |= 1ull << ((v | s) & 63);
+                if (((s - fre) & fre) == 0)
+                    break;
+            }
+        }
+    }
+    if (ni < 0 || no < 0)
+        return err("Missing .i or .o");
+    if (ons.empty()) {
+        size_t wds = (((size_t)1 << ni) + 63) / 64;
+        ons.assign(no, std::vector<uint64_t>(wds, 0));
+        dcs = ofs = ons;
+    }
+    // Unspecified minterms are don't-cares when the OFF-set is given, ON wins over OFF
+    for (int j = 0; j < no; ++j)
+        for (size_t w = 0; w < ons[j].size(); ++w) {
+            if (typ.back() == 'r')
+                dcs[j][w] |= ~(ons[j][w] | ofs[j][w]);
+            ons[j][w] &= ~dcs[j][w];
+        }
+    size_t lmt = (size_t)1 << ni;
+    if (lmt & 63)
+        for (int j = 0; j < no; ++j)
+            dcs[j].back() &= (1ull << (lmt & 63)) - 1;
+    // Default names
+    if (ilb.size() != (size_t)ni) {
+        ilb.clear();
+        for (int i = 0; i < ni; ++i)
+            ilb.emplace_back(1, 'A' + i);
+    }
+    if (ob.size() != (size_t)no) {
+        ob.clear();
+        for (int j = 0; j < no; ++j)
+            ob.emplace_back(no == 1 ? "Y" : "Y" + std::to_string(j));
+    }
+    return true;
+}
+
+// Buffered file writer
+class Writer {
+    private:
+        std::FILE *fp;
+        char buf[1 << 16];
+        size_t len;
+
+    public:
+        Writer(const std::string& file): fp(std::fopen(file.c_str(), "w")), len(0) {}
+        Writer(const Writer&) = delete;
+        ~Writer() {
+            if (fp) {
+                flush();
+                std::fclose(fp);
+            }
+        }
+        Writer& operator=(const Writer&) = delete;
+        bool ok() const {
+            return fp;
+        }
+        void flush() {
+            std::fwrite(buf, 1, len, fp);
+            len = 0;
+        }
+        Writer& operator<<(char c) {
+            if (len == sizeof(buf))
+                flush();
+            buf[len++] = c;
+            return *this;
+        }
+        Writer& operator<<(const char *str) {
+            for (; *str; ++str)
+                *this << *str;
+            return *this;
+        }
+        Writer& operator<<(const std::string& str) {
+            if (len + str.size() > sizeof(buf))
+                flush();
+            if (str.size() > sizeof(buf))
+                std::fwrite(str.data(), 1, str.size(), fp);
+            else {
+                std::memcpy(buf + len, str.data(), str.size());
+                len += str.size();
+            }
+            return *this;
+        }
+        Writer& operator<<(size_t x) {
+            char tmp[24];
+            std::snprintf(tmp, sizeof(tmp), "%zu", x);
+            return *this << tmp;
+        }
+};
+
+// Write PLA file
+// Identical cubes of different outputs share one row
+void writePla(const std::string& file, const std::vector<std::string>& ilb, const std::vector<std::string>& ob,
+              const std::vector<std::vector<std::string>>& cvs) {
+    Writer fout(file);
+    if (!fout.ok()) {
+        std::cerr << "[ERROR] Cannot write PLA file '" << file << '\'' << std::endl;
+        return;
+    }
+    std::vector<std::string> rows;
+    std::unordered_map<std::string, size_t> idx;
+    std::vector<std::string> outs;
+    for (size_t j = 0; j < cvs.size(); ++j)
+        for (auto &i : cvs[j]) {
+            auto it = idx.find(i);
+            if (it == idx.end()) {
+                it = idx.emplace(i, rows.size()).first;
+                rows.emplace_back(i);
+                outs.emplace_back(cvs.size(), '0');
+            }
+            outs[it->second][j] = '1';
+        }
+    fout << ".i " << ilb.size() << "\n.o " << ob.size() << "\n.ilb";
+    for (auto &i : ilb)
+        fout << ' ' << i;
+    fout << "\n.ob";
+    for (auto &i : ob)
+        fout << ' ' << i;
+    fout << "\n.p " << rows.size() << '\n';
+    for (size_t i = 0; i < rows.size(); ++i)
+        fout << rows[i] << ' ' << outs[i] << '\n';
+    fout << ".e\n";
+}
+
+// Write BLIF model
+// Cubes used by several outputs become shared nets, outputs OR their own cubes and shared nets
+void writeBlif(const std::string& file, const std::vector<std::string>& ilb, const std::vector<std::string>& ob,
+               const std::vector<std::vector<std::string>>& cvs) {
+    Writer fout(file);
+    if (!fout.ok()) {
+        std::cerr << "[ERROR] Cannot write BLIF file '" << file << '\'' << std::endl;
+        return;
+    }
+    // Count cube users
+    std::unordered_map<std::string, size_t> use, net;
+    for (auto &i : cvs)
+        for (auto &j : i)
+            ++use[j];
+    fout << ".model qma\n.inputs";
+    for (auto &i : ilb)
+        fout << ' ' << i;
+    fout << "\n.outputs";
+    for (auto &i : ob)
+        fout << ' ' << i;
+    fout << '\n';
+    // Shared nets, only care inputs are connected
+    for (auto &i : cvs)
+        for (auto &j : i)
+            if (use[j] > 1 && !net.count(j)) {
+                size_t id = net.size();
+                net[j] = id;
+                fout << ".names";
+                for (size_t k = 0; k < ilb.size(); ++k)
+                    if (j[k] != '-')
+                        fout << ' ' << ilb[k];
+                fout << " _t" << id << '\n';
+                for (auto &k : j)
+                    if (k != '-')
+                        fout << k;
+                fout << (j.find_first_not_of('-') == std::string::npos ? "1\n" : " 1\n");
+            }
+    // Outputs
+    for (size_t o = 0; o < cvs.size(); ++o) {
+        std::vector<size_t> sh;
+        for (auto &j : cvs[o])
+            if (use[j] > 1)
+                sh.emplace_back(net[j]);
+        fout << ".names";
+        for (auto &i : ilb)
+            fout << ' ' << i;
+        for (auto &i : sh)
+            fout << " _t" << i;
+        fout << ' ' << ob[o] << '\n';
+        for (auto &j : cvs[o])
+            if (use[j] == 1)
+                fout << j << std::string(sh.size(), '-') << " 1\n";
+        for (size_t i = 0; i < sh.size(); ++i) {
+            std::string tmp(ilb.size() + sh.size(), '-');
+            tmp[ilb.size() + i] = '1';
+            fout << tmp << " 1\n";
+        }
+    }
+    fout << ".end\n";
+}
+
+// Analyze PLA file
+// Every output is minimized on its own
+bool pla() {
+    int ni;
+    std::vector<std::string> ilb, ob;
+    std::vector<std::vector<uint64_t>> ons, dcs;
+    {
+        Phase ph("parse");
+        if (!readPla(ipla, ni, ilb, ob, ons, dcs))
+            return false;
+    }
+    std::vector<std::vector<std::string>> cvs;
+    for (size_t j = 0; j < ob.size(); ++j) {
+        std::vector<size_t> om, dm;
+        for (size_t i = 0, lmt = (size_t)1 << ni; i < lmt; ++i)
+            if ((ons[j][i >> 6] >> (i & 63)) & 1)
+                om.emplace_back(i);
+            else if ((dcs[j][i >> 6] >> (i & 63)) & 1)
+                dm.emplace_back(i);
+        if (om.empty())
+            cvs.emplace_back();
+        else if (om.size() + dm.size() == ((size_t)1 << ni))
+            cvs.push_back({std::string(ni, '-')});
+        else
+            cvs.emplace_back(QMA(ni, om, dm));
+        std::cout << ob[j] << " = " << sop(cvs.back(), ilb) << std::endl;
+    }
+    if (opla.size())
+        writePla(opla, ilb, ob, cvs);
+    if (oblif.size())
+        writeBlif(oblif, ilb, ob, cvs);
+    return true;
+}
+
+// Reset analyzing state
+void reset() {
+    var.clear();
+    mvar.clear();
+    m.clear();
+    on.clear();
+    mono = false;
+    nxor = -1;
+    delete root.l;
+    root.l = nullptr;
+}
+
+// Random number
+// Only raw engine output is used, distributions differ between platforms
+std::mt19937_64 rng;
+size_t rnd(size_t n) {
+    return rng() % n;
+}
+double rnf() {
+    return (rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Random expression
+// Returns the expression and whether it needs no parentheses as an operand
+std::pair<std::string, bool> rexp(int n, int d, const std::string& ops, bool top = true) {
+    if (d <= 0 || ops.empty() || (!top && !rnd(4))) {
+        std::string rtn(1, 'A' + rnd(n));
+        if (ops.find('\'') != std::string::npos && rnd(2))
+            rtn += '\'';
+        return {rtn, true};
+    }
+    char op = ops[rnd(ops.size())];
+    auto l = rexp(n, d - 1, ops, false);
+    if (!l.second)
+        l.first = '(' + l.first + ')';
+    if (op == '\'')
+        return {l.first + '\'', true};
+    auto r = rexp(n, d - 1, ops, false);
+    if (!r.second)
+        r.first = '(' + r.first + ')';
+    if (op == '*')
+        return {l.first + r.first, false};
+    return {l.first + op + r.first, false};
+}
+
+// Random ON/DC-set
+// Each minterm is ON with probability p, else don't-care with probability q
+void rset(int n, double p, double q, std::vector<size_t>& ons, std::vector<size_t>& dcs) {
+    ons.clear();
+    dcs.clear();
+    for (size_t i = 0, lmt = (size_t)1 << n; i < lmt; ++i) {
+        double tmp = rnf();
+        if (tmp < p)
+            ons.emplace_back(i);
+        else if (tmp < p + (1 - p) * q)
+            dcs.emplace_back(i);
+    }
+}
+
+// Generator
+int gen(int argc, char *argv[]) {
+    if (argc == 2 && !std::strcmp(argv[1], "npn"))
+        return npnGen();
+    if (argc < 2 || (std::strcmp(argv[1], "expr") && std::strcmp(argv[1], "set"))) {
+        std::cerr << "[ERROR] Usage: gen expr|set [options] or gen npn" << std::endl;
+        return 1;
+    }
+    bool ex = !std::strcmp(argv[1], "expr");
+    int n = 4, d = 4, cnt = 1;
+    double p = 0.5, q = 0;
+    std::string ops = "+*^'";
+    for (int i = 2; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt == "--vars" && i + 1 < argc)
+            n = std::atoi(argv[++i]);
+        else if (opt == "--depth" && i + 1 < argc)
+            d = std::atoi(argv[++i]);
+        else if (opt == "--ops" && i + 1 < argc)
+            ops = argv[++i];
+        else if (opt == "--seed" && i + 1 < argc)
+            rng.seed(std::strtoull(argv[++i], nullptr, 10));
+        else if (opt == "--count" && i + 1 < argc)
+            cnt = std::atoi(argv[++i]);
+        else if (opt == "--density" && i + 1 < argc)
+            p = std::atof(argv[++i]);
+        else if (opt == "--dc" && i + 1 < argc)
+            q = std::atof(argv[++i]);
+        else {
+            std::cerr << "[ERROR] Unknown option '" << opt << '\'' << std::endl;
+            return 1;
+        }
+    }
+    if (n < 1 || n > 26) {
+        std::cerr << "[ERROR] Variable count must be in 1..26" << std::endl;
+        return 1;
+    }
+    for (auto &i : ops)
+        if (i != '+' && i != '*' && i != '^' && i != '\'') {
+            std::cerr << "[ERROR] Invalid operator '" << i << '\'' << std::endl;
+            return 1;
+        }
+    if (ex) {
+        for (int i = 0; i < cnt; ++i)
+            std::cout << rexp(n, d, ops).first << '\n';
+        return 0;
+    }
+    // Sets as one PLA with an output per set, readable by --pla
+    size_t lmt = (size_t)1 << n;
+    std::vector<std::vector<uint64_t>> ob(cnt, std::vector<uint64_t>((lmt + 63) / 64, 0)), db(ob);
+    std::vector<size_t> ons, dcs;
+    for (int i = 0; i < cnt; ++i) {
+        rset(n, p, q, ons, dcs);
+        for (auto &j : ons)
+            ob[i][j >> 6] |= 1ull << (j & 63);
+        for (auto &j : dcs)
+            db[i][j >> 6] |= 1ull << (j & 63);
+    }
+    std::cout << ".i " << n << "\n.o " << cnt << "\n.type fd\n";
+    std::string row(n + 1 + cnt, ' ');
+    for (size_t x = 0; x < lmt; ++x) {
+        bool f = false;
+        for (int i = 0; i < cnt; ++i) {
+            char c = bit(ob[i], x) ? '1' : bit(db[i], x) ? '-' : '0';
+            row[n + 1 + i] = c;
+            f = f || c != '0';
+        }
+        if (!f)
+            continue;
+        for (int j = 0; j < n; ++j)
+            row[j] = (x >> (n - 1 - j)) & 1 ? '1' : '0';
+        std::cout << row << '\n';
+    }
+    std::cout << ".e\n";
+    return 0;
+}
+
+// Benchmark cases
+const std::pair<const char*, const char*> bcs[] = {
+    {"xor8", "A^B^C^D^E^F^G^H"},
+    {"mux4", "A'B'E+A'BF+AB'G+ABH"},
+    {"cmp4", "(A^E)'(B^F)'(C^G)'(D^H)'+AE'+(A^E)'BF'+(A^E)'(B^F)'CG'"},
+    {"maj7", "ABCD+ABCE+ABCF+ABCG+ABDE+ABDF+ABDG+ABEF+ABEG+ABFG+ACDE+ACDF+ACDG+ACEF+ACEG+ACFG+ADEF+ADEG+ADFG+AEFG+BCDE+BCDF+BCDG+BCEF+BCEG+BCFG+BDEF+BDEG+BDFG+BEFG+CDEF+CDEG+CDFG+CEFG+DEFG"},
+    {"mix10", "(AB'+CD)^(EF'+G'H)+(I^J)'A'C"}
+};
+
+// Generated benchmark cases
+// Name, variables, depth, operator mix, seed
+const std::tuple<const char*, int, int, const char*, uint64_t> gcs[] = {
+    {"rand10a", 10, 6, "+*^'", 1},
+    {"rand10b", 10, 6, "+*^'", 2},
+    {"randx9", 9, 5, "+*^^'", 6}
+};
+
+// Generated ON/DC-set cases
+// Name, variables, ON density, DC density, seed
+const std::tuple<const char*, int, double, double, uint64_t> dsc[] = {
+    {"set10", 10, 0.4, 0.2, 1},
+    {"set12", 12, 0.3, 0.1, 2},
+    {"sparse16", 16, 0.005, 0.005, 3}
+};
+
+// Clustered ON-set cases, dense in a subcube of a sparse space. Run with --primes auto and merge,
+// auto must not be slower
+// Name, variables, subcube variables, ON density in the subcube, seed
+const std::tuple<const char*, int, int, double, uint64_t> ccs[] = {
+    {"clust14", 14, 11, 0.85, 4}
+};
+
+// Thread scaling cases
+// Large enough for many tvt chunks and merge chunks per thread
+const std::pair<const char*, const char*> scs[] = {
+    {"dense16", "(AB+CD)(EF'+G'H)(IJ'+K'L)(MN+O'P')"},
+    {"sparse20", "ABCDEFGH(I^J^K^L)+A'B'C'D'E'(MNOP+QRST)"}
+};
+
+// Median and median absolute deviation
+std::pair<double, double> mmad(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    double med = v[v.size() / 2];
+    for (auto &i : v)
+        i = std::fabs(i - med);
+    std::sort(v.begin(), v.end());
+    return {med, v[v.size() / 2]};
+}
+
+// Thread scaling benchmark
+// Median phase times per thread count, speedup and efficiency against 1 thread
+int scaling(int rep, int mxt) {
+    const char *pnm[3] = {"tvt", "primes", "cover"};
+    std::vector<int> tcs;
+    for (int t = 1; t < mxt; t <<= 1)
+        tcs.emplace_back(t);
+    tcs.emplace_back(mxt);
+    std::printf("%-10s %7s", "case", "threads");
+    for (auto &i : pnm)
+        std::printf(" %12s %8s %6s", (std::string(i) + "(ms)").c_str(), "speedup", "eff");
+    std::printf("\n");
+    std::streambuf *buf = std::cout.rdbuf(nullptr);
+    otable = false;
+    // Always generate primes and cover, so that every column is measured
+    std::string eng = oengine;
+    oengine = "qm";
+    for (auto &c : scs) {
+        double bas[3] = {0, 0, 0};
+        for (auto &t : tcs) {
+            othreads = t;
+            // Start the pool outside the timed runs
+            pfor(t, [](size_t) {});
+            std::vector<double> tms[3];
+            for (int j = 0; j < rep; ++j) {
+                reset();
+                clearStats();
+                input = c.second;
+                if (validate())
+                    analyze();
+                double tmp[3] = {0, 0, 0};
+                for (int k = 0; k < nph; ++k)
+                    if (!std::strcmp(phs[k].name, "tvt"))
+                        tmp[0] += phs[k].ms;
+                    else if (!std::strncmp(phs[k].name, "merge", 5) || !std::strcmp(phs[k].name, "consensus") ||
+                             !std::strncmp(phs[k].name, "symmetry", 8))
+                        tmp[1] += phs[k].ms;
+                    else if (!std::strcmp(phs[k].name, "cover"))
+                        tmp[2] += phs[k].ms;
+                for (int k = 0; k < 3; ++k)
+                    tms[k].emplace_back(tmp[k]);
+            }
+            std::printf("%-10s %7d", c.first, t);
+            for (int k = 0; k < 3; ++k) {
+                double med = mmad(tms[k]).first;
+                if (t == 1)
+                    bas[k] = med;
+                double spd = med > 0 ? bas[k] / med : 0;
+                std::printf(" %12.3f %7.2fx %5.0f%%", med, spd, spd / t * 100);
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    }
+    oengine = eng;
+    reset();
+    clearStats();
+    std::cout.rdbuf(buf);
+    std::cout.clear();
+    return 0;
+}
+
+// Benchmark
+// Exit code 1 on significant regression against the baseline
+int bench(int argc, char *argv[]) {
+    int rep = 11, mxt = std::max(1u, std::thread::hardware_concurrency());
+    double thr = 10;
+    bool scl = false;
+    std::string sav, cmp;
+    for (int i = 1; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt == "--scaling")
+            scl = true;
+        else if (opt == "--max-threads" && i + 1 < argc)
+            mxt = std::max(1, std::atoi(argv[++i]));
+        else if (opt == "--repeat" && i + 1 < argc)
+            rep = std::max(1, std::atoi(argv[++i]));
+        else if (opt == "--threshold" && i + 1 < argc)
+            thr = std::atof(argv[++i]);
+        else if (opt == "--save" && i + 1 < argc)
+            sav = argv[++i];
+        else if (opt == "--compare" && i + 1 < argc)
+            cmp = argv[++i];
+        else {
+            std::cerr << "[ERROR] Unknown option '" << opt << '\'' << std::endl;
+            return 1;
+        }
+    }
+    if (scl)
+        return scaling(rep, mxt);
+    // Load baseline
+    std::unordered_map<std::string, std::pair<double, double>> bl;
+    if (cmp.size()) {
+        std::ifstream fin(cmp);
+        if (!fin) {
+            std::cerr << "[ERROR] Cannot read baseline '" << cmp << '\'' << std::endl;
+            return 1;
+        }
+        std::string name;
+        double med, mad;
+        while (fin >> name >> med >> mad)
+            bl[name] = {med, mad};
+    }
+    // Run cases with output muted
+    std::vector<std::pair<std::string, std::pair<double, double>>> res;
+    std::streambuf *buf = std::cout.rdbuf(nullptr);
+    otable = false;
+    std::vector<std::pair<std::string, std::string>> cs(std::begin(bcs), std::end(bcs));
+    for (auto &i : gcs) {
+        rng.seed(std::get<4>(i));
+        cs.emplace_back(std::get<0>(i), rexp(std::get<1>(i), std::get<2>(i), std::get<3>(i)).first);
+    }
+    // Time per iteration, a sample repeats f for at least 50 ms so that short cases aren't
+    // dominated by timer resolution and scheduling
+    auto tim = [](const std::function<void()>& f) {
+        auto st = std::chrono::steady_clock::now();
+        double el = 0;
+        size_t k = 0;
+        do {
+            f();
+            ++k;
+            el = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - st).count();
+        } while (el < 50);
+        return el / k;
+    };
+    // Cases by name, samples are taken round by round so that drift hits all cases alike
+    std::vector<std::pair<std::string, std::function<void()>>> run;
+    for (auto &i : cs)
+        run.emplace_back(i.first, [&i]() {
+            reset();
+            input = i.second;
+            if (validate())
+                analyze();
+        });
+    size_t nd = std::end(dsc) - std::begin(dsc);
+    std::vector<std::vector<size_t>> ons(nd), dcs(nd);
+    for (size_t k = 0; k < nd; ++k) {
+        auto &i = dsc[k];
+        rng.seed(std::get<4>(i));
+        rset(std::get<1>(i), std::get<2>(i), std::get<3>(i), ons[k], dcs[k]);
+        run.emplace_back(std::get<0>(i), [&, k]() {
+            QMA(std::get<1>(dsc[k]), ons[k], dcs[k]);
+        });
+    }
+    size_t nc = std::end(ccs) - std::begin(ccs);
+    std::vector<std::vector<size_t>> cos(nc);
+    for (size_t k = 0; k < nc; ++k) {
+        auto &i = ccs[k];
+        std::vector<size_t> tmp;
+        rng.seed(std::get<4>(i));
+        rset(std::get<2>(i), std::get<3>(i), 0, cos[k], tmp);
+        size_t pre = rnd((size_t)1 << (std::get<1>(i) - std::get<2>(i))) << std::get<2>(i);
+        for (auto &j : cos[k])
+            j |= pre;
+        for (const char *pm : {"auto", "merge"})
+            run.emplace_back(std::string(std::get<0>(i)) + "/" + pm, [&, k, pm]() {
+                std::string tmp = oprimes;
+                oprimes = pm;
+                QMA(std::get<1>(ccs[k]), cos[k], {});
+                oprimes = tmp;
+            });
+    }
+    std::vector<std::vector<double>> tms(run.size());
+    for (int j = 0; j < rep; ++j)
+        for (size_t k = 0; k < run.size(); ++k)
+            tms[k].emplace_back(tim(run[k].second));
+    for (size_t k = 0; k < run.size(); ++k)
+        res.emplace_back(run[k].first, mmad(tms[k]));
+    reset();
+    std::cout.rdbuf(buf);
+    std::cout.clear();
+    // Report
+    // A case regresses when it is slower by more than the threshold and by more than 3 MADs.
+    // MADs are at least 2% of the median, a few equal samples don't make any change significant
+    int rtn = 0;
+    std::printf("%-14s %12s %10s", "case", "median(ms)", "MAD");
+    if (cmp.size())
+        std::printf(" %12s %9s", "base(ms)", "speedup");
+    std::printf("\n");
+    for (auto &i : res) {
+        std::printf("%-14s %12.3f %10.3f", i.first.c_str(), i.second.first, i.second.second);
+        auto it = bl.find(i.first);
+        if (it != bl.end()) {
+            double nw = i.second.first, od = it->second.first;
+            double nz = 3 * std::max({i.second.second, it->second.second, 0.02 * nw, 0.02 * od});
+            std::printf(" %12.3f %8.2fx", od, nw > 0 ? od / nw : 0);
+            if (nw > od * (1 + thr / 100) && nw - od > nz) {
+                std::printf("  REGRESSION");
+                rtn = 1;
+            }
+            else if (od > nw * (1 + thr / 100) && od - nw > nz)
+                std::printf("  improved");
+        }
+        else if (cmp.size())
+            std::printf(" %12s %9s", "-", "-");
+        std::printf("\n");
+    }
+    std::fflush(stdout);
+    // Save baseline
+    if (sav.size()) {
+        std::ofstream fout(sav);
+        if (!fout) {
+            std::cerr << "[ERROR] Cannot write baseline '" << sav << '\'' << std::endl;
+            return 1;
+        }
+        for (auto &i : res)
+            fout << i.first << ' ' << i.second.first << ' ' << i.second.second << '\n';
+    }
+    return rtn;
 }
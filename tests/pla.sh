@@ -0,0 +1,34 @@
+#!/bin/sh
+# PLA input regression cases
+# Usage: tests/pla.sh [QMA binary], default ./qma
+QMA=${1:-./qma}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+fail=0
+
+# Expect exit code $1 for PLA text $2
+run() {
+    printf '%b' "$2" > "$TMP/in.pla"
+    "$QMA" --pla "$TMP/in.pla" > /dev/null 2>&1
+    rc=$?
+    if [ "$rc" != "$1" ]; then
+        echo "FAIL: expected $1, got $rc for: $2"
+        fail=1
+    fi
+}
+
+# Too many inputs in a header-only file must be rejected before allocating
+run 1 '.i 40\n.o 1\n.e\n'
+run 1 '.i 64\n.o 1\n.e\n'
+run 1 '.i -1\n.o 1\n.e\n'
+run 1 '.i 27\n.o 1\n0000000000000000000000000001 1\n.e\n'
+# Unknown directives must be rejected, not skipped
+run 1 '.i 2\n.o 1\n.mv 3 0 2 2\n11 1\n.e\n'
+run 1 '.i 2\n.o 1\n.phase 0\n11 1\n.e\n'
+# Valid files
+run 0 '.i 2\n.o 1\n.e\n'
+run 0 '.i 3\n.o 1\n1-0 1\n011 1\n.e\n'
+run 0 '.i 3\n.o 1\n.p 2\n1-0 1\n011 1\n.e\n'
+
+[ "$fail" = 0 ] && echo "All PLA cases passed"
+exit $fail